@@ -1,817 +1,359 @@
-#include <iostream>
-#include <fstream>
-#include <string>
-#include <cstdlib>
+#include "src/Kingdom.h"
+#include "src/ActionSource.h"
+#include "src/ActionLog.h"
+#include "src/ReplayEngine.h"
+#include "src/MonteCarloRunner.h"
+#include "src/BalanceSweep.h"
+#include "src/MctsPlayer.h"
+#include "src/World.h"
+#include "src/Battlefield.h"
+#include "src/Profiler.h"
+#include "src/StatusRenderer.h"
+#include "src/Telemetry.h"
+#include "src/CheckpointStream.h"
+#include "src/KingdomArchive.h"
+#include "src/Autosave.h"
+#ifdef __linux__
+#include "src/GameServer.h"
+#include "src/LoadClient.h"
+#include <csignal>
+#endif
 #include <ctime>
-#include <thread>   // For sleep functions
+#include <climits>
 #include <chrono>
-using namespace std;
 
-enum Difficulty { EASY, MEDIUM, HARD };
+#ifdef __linux__
+static GameServer* runningServer = nullptr;
 
-// Forward declarations
-class Kingdom;
-class Population;
-class Army;
-class Bank;
-class Market;
-class BuildingSystem;
-
-class Event {
-public:
-    string description;
-    int foodChange, goldChange, happinessChange, armyChange, populationChange;
-    Event(string desc, int food, int gold, int happy, int army, int pop)
-        : description(desc), foodChange(food), goldChange(gold),
-        happinessChange(happy), armyChange(army), populationChange(pop) {}
-};
-
-class Leader {
-public:
-    string name;
-    int leadership;
-    int corruption;
-    Leader(string n, int l, int c) : name(n), leadership(l), corruption(c) {}
-    virtual void makeDecision() = 0;
-    virtual ~Leader() {}
-};
-
-class King : public Leader {
-public:
-    int taxRate;
-    string Commander;
-    King(string n, int l = 50, int c = 10) : Leader(n, l, c), taxRate(15) {}
-    void makeDecision() override {
-        cout << name << " makes a royal decree.\n";
-    }
-    void setTaxRate(int rate) {
-        if (rate < 5 || rate > 50) {
-            cout << "Tax rate must be between 5% and 50%\n";
-            return;
-        }
-        taxRate = rate;
-        cout << name << " set tax rate to " << taxRate << "%.\n";
-    }
-    void appointCommander(string ComName) {
-        Commander = ComName;
-        cout << name << " appointed " << Commander << " as commander.\n";
-    }
-};
-
-class Commander : public Leader {
-public:
-    int loyalty;
-    Commander(string n, int l = 60, int c = 5) : Leader(n, l, c), loyalty(70) {}
-    void makeDecision() override {
-        cout << name << " gives military orders.\n";
-    }
-};
-
-class MerchantLeader : public Leader {
-public:
-    MerchantLeader(string n, int l = 40, int c = 30) : Leader(n, l, c) {}
-    void makeDecision() override {
-        cout << name << " negotiates trade deals.\n";
-    }
-};
-
-template <typename T>
-class Inventory {
-private:
-    T quantity;
-public:
-    Inventory(T q = 0) : quantity(q) {}
-    void add(T amount) {
-        quantity += amount;
-    }
-
-    void remove(T amount) {
-        if (amount > quantity) {
-            cout << "Not enough resources\n";
-            return;
-        }
-        quantity -= amount;
-    }
-
-    T get() const {return quantity;
-    }
-
-    void set(T q) {
-        quantity = q;
-    }
-};
-
-class Population {
-private:
-    int peasants;
-    int merchants;
-    int nobility;
-    int soldiers;
-    int happiness;
-    friend class Disasters;
-public:
-
-    Population(int p, int m, int n, int s, int h) :
-        peasants(p), merchants(m), nobility(n), soldiers(s), happiness(h) {}
-
-    int getTotal() const {
-        return peasants + merchants + nobility + soldiers;
-    }
-
-    int getHappiness() const {
-        return happiness;
-    }
-
-    int getPeasants() const {
-        return peasants;
-    }
-
-    void updateHappiness(int change) {
-        happiness += change;
-        if (happiness > 100) {
-            happiness = 100;
-        }
-        if (happiness < 0) {
-            happiness = 0;
-        }
-    }
-
-    void addPeasants(int count) {
-        peasants += count;
-    }
-
-    void removePeasants(int count) {
-        peasants -= count; if (peasants < 0) peasants = 0;
-    }
-
-    void addSoldiers(int count) {
-        soldiers += count;
-    }
-
-    void starve(int foodShortage) {
-        int deaths = foodShortage / 2;
-        peasants -= deaths;
-        if (peasants < 0) peasants = 0;
-        updateHappiness(-20);
-    }
-
-    void plague() {
-        int deaths = getTotal() * 0.1;
-        peasants -= deaths * 0.7;
-        merchants -= deaths * 0.15;
-        nobility -= deaths * 0.1;
-        soldiers -= deaths * 0.05;
-        updateHappiness(-30);
-    }
-};
-
-class Army {
-private:
-    int soldiers;
-    int weapons;
-    int morale;
-    bool inWar;
-public:
-    Army(int s, int w, int m) : soldiers(s), weapons(w), morale(m), inWar(false) {}
-
-    int getSoldiers() const {
-        return soldiers;
-    }
-
-    int getMorale() const {
-        return morale;
-    }
-
-    void recruit(int count, Population& population) {
-        if (count > population.getPeasants() / 10) {
-            cout << "Cannot recruit more than 10% of peasant population\n";
-            return;
-        }
-        soldiers += count;
-        population.removePeasants(count);
-        cout << "Recruited " << count << " soldiers.\n";
-    }
-
-    void train() {
-        cout << "Training soldiers...\n";
-        // Simulate delay without thread/sleep
-        for (int i = 0; i < 100000000; i++) {} // Simple busy wait
-        morale += 10;
-        if (morale > 100) morale = 100;
-        cout << "Training complete! Morale +10\n";
-    }
-
-    void paySoldiers(int amount, Inventory<int>& gold) {
-        if (gold.get() < amount) {
-            cout << "Not enough gold to pay soldiers\n";
-            return;
-        }
-        gold.remove(amount);
-        morale += 5;
-        cout << "Soldiers paid. Morale +5\n";
-    }
-
-    void battle() {
-        if (soldiers == 0) {
-            cout << "No soldiers to fight\n";
-            return;
-        }
-        inWar = true;
-        int casualties = rand() % (soldiers / 4);
-        soldiers -= casualties;
-        morale -= 15;
-        cout << "Battle fought! Lost " << casualties << " soldiers. Morale -15\n";
-    }
-};
-
-class Bank {
-private:
-    int goldReserve;
-    float trustRate; // 1.0 = full trust, 0.0 = no trust
-public:
-    Bank(int reserve = 10000) : goldReserve(reserve), trustRate(1.0f) {}
-    void giveLoan(int amount, Inventory<int>& kingdomGold) {
-        if (amount > goldReserve) {
-            cout << " Bank cannot provide this loan: insufficient reserve.\n";
-            return;
-        }
-        goldReserve -= amount;
-        kingdomGold.add(amount);
-        cout << " Bank loaned " << amount << " gold to the kingdom.\n";
-    }
-
-    void receiveRepayment(int amount, Inventory<int>& kingdomGold) {
-        if (kingdomGold.get() < amount) {
-            cout << " Kingdom lacks enough gold to repay loan.\n";
-            trustRate -= 0.1f;
-            if (trustRate < 0.0f) trustRate = 0.0f;
-            return;
-        }
-        kingdomGold.remove(amount);
-        goldReserve += amount;
-        trustRate += 0.05f;
-        if (trustRate > 1.0f) trustRate = 1.0f;
-        cout << " Loan of " << amount << " gold repaid. Trust rate increased.\n";
-    }
-
-    void audit() const {
-        cout << "\n Bank Audit Report:\n";
-        cout << "Gold Reserve: " << goldReserve << "\n";
-        cout << "Trust Rate: " << trustRate * 100 << "%\n";
-    }
-
-    float getTrustRate() const {
-        return trustRate;
-    }
-    int getReserve() const {
-        return goldReserve;
-    }
-
-};
-
-class Market {
-private:
-    struct TradeRoute {
-        string name;
-        int value;
-    };
-    TradeRoute tradeRoutes[5]; // Fixed size instead of vector
-    int routeCount;
-    int foodPrice;
-    int weaponPrice;
-public:
-    Market() : foodPrice(1), weaponPrice(5), routeCount(1) {
-        tradeRoutes[0] = { "Neighbor Kingdom", 50 };
-    }
-
-    void buyFood(int amount, Inventory<int>& food, Inventory<int>& gold) {
-        int cost = amount * foodPrice;
-        if (gold.get() < cost) {
-            cout << "Not enough gold\n";
-            return;
-        }
-        gold.remove(cost);
-        food.add(amount);
-        cout << "Bought " << amount << " food for " << cost << " gold.\n";
-    }
-
-    void sellFood(int amount, Inventory<int>& food, Inventory<int>& gold) {
-        if (food.get() < amount) {
-            cout << "Not enough food\n";
-            return;
-        }
-        food.remove(amount);
-        gold.add(amount * foodPrice * 0.8); // 80% of buy price
-        cout << "Sold " << amount << " food for " << amount * foodPrice * 0.8 << " gold.\n";
-    }
-
-    void updatePrices() {
-        foodPrice += rand() % 3 - 1; // -1 to +1 change
-        weaponPrice += rand() % 5 - 2; // -2 to +2 change
-        if (foodPrice < 1) foodPrice = 1;
-        if (weaponPrice < 3) weaponPrice = 3;
-    }
-
-    void showPrices() const {
-        cout << "Market Prices:\n";
-        cout << "Food: " << foodPrice << " gold per unit\n";
-        cout << "Weapons: " << weaponPrice << " gold per unit\n";
-    }
-};
-
-class BuildingSystem {
-private:
-    int farms;
-    int barracks;
-    int mines;
-    int blacksmiths;
-public:
-    BuildingSystem() : farms(1), barracks(1), mines(1), blacksmiths(1) {}
-
-    int getFarms() const { return farms; }
-    int getBarracks() const { return barracks; }
-
-    void buildFarm(Inventory<int>& wood, Inventory<int>& stone) {
-        if (wood.get() < 50 || stone.get() < 30) {
-            cout << "Not enough resources\n";
-            return;
-        }
-        wood.remove(50);
-        stone.remove(30);
-        farms++;
-        cout << "Built a new farm. Total farms: " << farms << "\n";
-    }
-
-    void buildBarracks(Inventory<int>& wood, Inventory<int>& stone) {
-        if (wood.get() < 80 || stone.get() < 50) {
-            cout << "Not enough resources\n";
-            return;
-        }
-        wood.remove(80);
-        stone.remove(50);
-        barracks++;
-        cout << "Built a new barracks. Total barracks: " << barracks << "\n";
-    }
-
-    void produceResources(Inventory<int>& food, Inventory<int>& iron) {
-        food.add(farms * 100);
-        iron.add(mines * 20);
-    }
-};
-
-class Kingdom {
-public:
-    int turn;
-    Difficulty difficulty;
-    King* currentKing;
-    Population population;
-    Army army;
-    Bank bank;
-    Market market;
-    BuildingSystem buildings;
-    Inventory<int> food;
-    Inventory<int> gold;
-    Inventory<int> wood;
-    Inventory<int> stone;
-    Inventory<int> iron;
-    Inventory<int> weapons;
-    int lastDisasterTurn;
-    int lastWarTurn;
-    int lastElectionTurn;
-    bool gameOver;
+static void stopServer(int) {
+    if (runningServer) runningServer->stop();
+}
+#endif
 
-    void randomEvent() {
-        int event = rand() % 10;
-        switch (event) {
-        case 0: {
-            int plagueDeaths = population.getTotal() * 0.1;
-            cout << "A plague has killed " << plagueDeaths << " people!\n";
-            population.plague();
-            break;
-        }
-        case 1: {
-            int goldFound = 100 + rand() % 200;
-            cout << "Miners found a gold vein! +" << goldFound << " gold.\n";
-            gold.add(goldFound);
-            break;
-        }
-        case 2: {
-            cout << "Merchants report increased trade! Happiness +5\n";
-            population.updateHappiness(5);
-            break;
-        }
-        case 3: {
-            cout << "Bandits attacked a trade route! Gold -50\n";
-            gold.remove(50);
-            break;
-        }
-        case 4: {
-            cout << "Good harvest this season! Food +200\n";
-            food.add(200);
-            break;
-        }
-        }
+// Reads a difficulty argument of 1-3; says so and returns false if it is not
+static bool parseDifficulty(const char* arg, Difficulty& diff) {
+    int level = atoi(arg);
+    if (!isDifficulty(level - 1)) {
+        cout << "Difficulty must be 1, 2 or 3, not " << arg << "\n";
+        return false;
     }
+    diff = static_cast<Difficulty>(level - 1);
+    return true;
+}
 
-    void checkElection() {
-        if (turn - lastElectionTurn >= 5) {
-            cout << "\n=== ELECTION TIME ===\n";
-            int approval = population.getHappiness() / 2 + rand() % 30;
-
-            if (approval < 40) {
-                cout << "The people are unhappy! " << currentKing->name << " has been overthrown!\n";
-                delete currentKing;
-                currentKing = new King("King_" + to_string(turn));
-                population.updateHappiness(20); // New king happiness boost
+int main(int argc, char* argv[]) {
+    // stronghold --simulate <games> [difficulty 1-3] [seed] [--profile <file.json|file.csv>]
+    //                     [--telemetry <file>] [--checkpoints <file>]
+    if (argc >= 3 && string(argv[1]) == "--simulate") {
+        string profilePath, telemetryPath, checkpointPath;
+        while (argc >= 5) {
+            string option = argv[argc - 2];
+            if (option == "--profile") profilePath = argv[argc - 1];
+            else if (option == "--telemetry") telemetryPath = argv[argc - 1];
+            else if (option == "--checkpoints") checkpointPath = argv[argc - 1];
+            else break;
+            argc -= 2;
+        }
+        if (!profilePath.empty()) Profiler::enable(true);
+        TelemetryWriter telemetry;
+        if (!telemetryPath.empty() && !telemetry.open(telemetryPath)) {
+            cout << "Could not write telemetry to " << telemetryPath << "\n";
+            return 1;
+        }
+        CheckpointWriter checkpoints;
+        if (!checkpointPath.empty() && !checkpoints.open(checkpointPath)) {
+            cout << "Could not write checkpoints to " << checkpointPath << "\n";
+            return 1;
+        }
+        uint64_t games = strtoull(argv[2], nullptr, 10);
+        Difficulty diff = MEDIUM;
+        if (argc >= 4 && !parseDifficulty(argv[3], diff)) return 1;
+        uint64_t seed = argc >= 5 ? strtoull(argv[4], nullptr, 10) : 1;
+        MonteCarloRunner runner;
+        SimulationReport report = runner.run(diff, games, seed, randomPolicy,
+            telemetry.isOpen() ? &telemetry : nullptr, checkpoints.isOpen() ? &checkpoints : nullptr);
+        cout << "Simulated on " << runner.threadCount() << " threads\n";
+        report.print(cout);
+        if (telemetry.isOpen()) {
+            telemetry.close();
+            cout << "Telemetry: " << telemetry.rowsWritten() << " turns in " << telemetry.bytesWritten()
+                << " bytes\n";
+        }
+        if (checkpoints.isOpen()) {
+            checkpoints.close();
+            cout << "Checkpoints: " << checkpoints.framesWritten() << " turns (" << checkpoints.keyframesWritten()
+                << " keyframes) in " << checkpoints.bytesWritten() << " bytes, "
+                << checkpoints.framesWritten() * (sizeof(ArchiveHeader) + sizeof(KingdomRecord))
+                << " as separate binary saves\n";
+        }
+        if (!profilePath.empty()) {
+            ofstream profileFile(profilePath);
+            if (profilePath.size() >= 4 && profilePath.compare(profilePath.size() - 4, 4, ".csv") == 0) {
+                Profiler::writeCsv(profileFile);
             }
             else {
-                cout << currentKing->name << " remains in power with " << approval << "% approval.\n";
+                Profiler::writeJson(profileFile);
             }
-
-            lastElectionTurn = turn;
-        }
-    }
-
-    void checkGameOver() {
-        if (population.getTotal() <= 0) {
-            cout << "GAME OVER: Everyone has died. The kingdom has fallen.\n";
-            gameOver = true;
-            return;
-        }
-        if (food.get() <= 0) {
-            cout << "GAME OVER: No food left. The kingdom has starved.\n";
-            gameOver = true;
-            return;
-        }
-        if (gold.get() < -1000) {
-            cout << "GAME OVER: The kingdom is bankrupt.\n";
-            gameOver = true;
-            return;
-        }
-        if (population.getHappiness() <= 10) {
-            cout << "GAME OVER: The people have revolted and overthrown the kingdom.\n";
-            gameOver = true;
-            return;
-        }
-        if (army.getSoldiers() == 0 && rand() % 10 == 0) {
-            cout << "GAME OVER: Enemy kingdom attacked and conquered your defenseless land.\n";
-            gameOver = true;
-            return;
-        }
-        if (turn >= 20) {
-            cout << "\n\n=== YOU WIN! ===\n";
-            cout << "Your kingdom has survived 20 turns and proven its stability!\n";
-            cout << "Final Stats:\n";
-            showStatus();
-            gameOver = true;
-            return;
-        }
-    }
-
-public:
-    Kingdom(Difficulty diff) :
-        difficulty(diff),
-        turn(1),
-        currentKing(new King("King_1")),
-        population(100, 20, 10, 30, 70),
-        army(30, 50, 60),
-        lastDisasterTurn(-5),
-        lastWarTurn(-5),
-        lastElectionTurn(0),
-        gameOver(false) {
-
-        switch (diff) {
-        case EASY:
-            food.set(1000);
-            gold.set(1000);
-            wood.set(200);
-            stone.set(200);
-            iron.set(150);
-            weapons.set(100);
-            break;
-        case MEDIUM:
-            food.set(700);
-            gold.set(700);
-            wood.set(150);
-            stone.set(150);
-            iron.set(100);
-            weapons.set(70);
-            break;
-        case HARD:
-            food.set(500);
-            gold.set(500);
-            wood.set(100);
-            stone.set(100);
-            iron.set(70);
-            weapons.set(50);
-            break;
-        }
-    }
-
-    ~Kingdom() {
-        delete currentKing;
-    }
-
-    void showStatus() const {
-        cout << "\n--------------------------\n";
-        cout << "Loading kingdom status...\n";
-        cout << "--------------------------\n";
-
-        this_thread::sleep_for(std::chrono::seconds(2));
-        system("cls");
-
-        cout << "\n=== KINGDOM STATUS (Turn " << turn << ") ===\n";
-        cout << "King: " << currentKing->name << endl;
-        cout << "Tax: " << currentKing->taxRate << "%\n";
-        cout << "Population: " << population.getTotal() << endl;
-        cout << "Happiness: " << population.getHappiness() << "%\n";
-        cout << "Food: " << food.get() << endl;
-        cout << "Gold: " << gold.get() << "\n";
-        cout << "Resources: Wood=" << wood.get() << " Stone=" << stone.get()
-            << " Iron=" << iron.get() << " Weapons=" << weapons.get() << "\n";
-        cout << "Army: " << army.getSoldiers() << " soldiers (Morale: " << army.getMorale() << "%)\n";
-        cout << "Buildings: Farms=" << buildings.getFarms() << " Barracks=" << buildings.getBarracks() << "\n";
-        cout << "------------------------------------\n";
-    
-    }
-
-    void nextTurn() {
-        if (gameOver) return;
-
-        turn++;
-        cout << "\n=== TURN " << turn << " BEGINS ===\n";
-
-        // Consume food
-        int foodConsumption = population.getTotal() / 2;
-        food.remove(foodConsumption);
-        cout << "Consumed " << foodConsumption << " food.\n";
-
-        // Pay soldiers
-        army.paySoldiers(army.getSoldiers() * 2, gold);
-
-        // Produce resources
-        buildings.produceResources(food, iron);
-
-        // Random events
-        if (rand() % 4 == 0) {
-            randomEvent();
-        }
-
-        // Check for elections
-        checkElection();
-
-        // Check for disasters
-        int disasterInterval = (difficulty == EASY) ? 3 : 2;
-        if (turn - lastDisasterTurn >= disasterInterval) {
-            string disasters[] = { "Earthquake", "Famine", "Flood" };
-            //Disasters::applyDisaster(*this, disasters[rand() % 3]);
-            lastDisasterTurn = turn;
         }
-
-        // Update market prices
-        market.updatePrices();
-
-        // Check game over conditions
-        checkGameOver();
-    }
-
-    void playerTurn() {
-        if (gameOver) return;
-
-        showStatus();
-
-        cout << "\n=== ACTIONS ===\n";
-        cout << "1. Collect Taxes\n";
-        cout << "2. Change Tax Rate\n";
-        cout << "3. Recruit Soldiers\n";
-        cout << "4. Train Soldiers\n";
-        cout << "5. Buy/Sell Food\n";
-        cout << "6. Build Farm\n";
-        cout << "7. Build Barracks\n";
-        cout << "8. Take Loan\n";
-        cout << "0. Quit Game\n";
-
-        int choice;
-        cout << "\nChoose action: ";
-        cin >> choice;
-        cout << "--------------------------\n";
-        switch (choice) {
-        case 1: {
-            int taxAmount = (population.getTotal() * currentKing->taxRate) / 100;
-            gold.add(taxAmount);
-            population.updateHappiness(-5);
-            cout << "Collected " << taxAmount << " gold in taxes. Happiness -5.\n";
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            break;
-        }
-        case 2: {
-            int newRate;
-            cout << "Enter new tax rate (5-50): ";
-            cin >> newRate;
-            currentKing->setTaxRate(newRate);
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            break;
-        }
-        case 3: {
-            int recruits;
-            cout << "Enter number of soldiers you want to recruit: ";
-            cin >> recruits;
-            army.recruit(recruits, population);
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            break;
-        }
-        case 4: {
-            army.train();
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            break;
-        }
-        case 5: {
-            cout << "1. Buy Food\n2. Sell Food\n";
-            int subchoice;
-            cin >> subchoice;
-            if (subchoice == 1) {
-                int amount;
-                cout << "How much food to buy: ";
-                cin >> amount;
-                market.buyFood(amount, food, gold);
+        return 0;
+    }
+
+    // stronghold --replay <action log> [turn]
+    if (argc >= 3 && string(argv[1]) == "--replay") {
+        ActionLog log;
+        if (!log.load(argv[2])) {
+            cout << "Could not read action log " << argv[2] << "\n";
+            return 1;
+        }
+        ReplayEngine replay(log);
+        replay.fastForward(argc >= 4 ? atoi(argv[3]) : INT_MAX);
+        narrator().setPaced(false);
+        replay.state().showStatus();
+        if (replay.state().isGameOver()) {
+            cout << "Outcome: " << outcomeName(replay.state().getOutcome()) << "\n";
+        }
+        return 0;
+    }
+
+    // stronghold --checkpoint <checkpoint file> <game> <turn>
+    if (argc >= 5 && string(argv[1]) == "--checkpoint") {
+        CheckpointReader checkpoints;
+        if (!checkpoints.open(argv[2])) {
+            cout << "Could not read checkpoints from " << argv[2] << "\n";
+            return 1;
+        }
+        Kingdom game(MEDIUM, 0);
+        if (!checkpoints.restore(static_cast<uint32_t>(strtoul(argv[3], nullptr, 10)), atoi(argv[4]), game)) {
+            cout << "No checkpoint of game " << argv[3] << " at turn " << argv[4] << "\n";
+            return 1;
+        }
+        narrator().setPaced(false);
+        game.showStatus();
+        if (game.isGameOver()) {
+            cout << "Outcome: " << outcomeName(game.getOutcome()) << "\n";
+        }
+        return 0;
+    }
+
+    // stronghold --sweep <games per candidate> <param=low:high:steps>... [--random <candidates>]
+    //                  [--difficulty 1-3] [--seed s] [--target <win rate>]
+    // Prints one CSV row per candidate, then the one closest to the target
+    // win rate (default 0.5).
+    if (argc >= 4 && string(argv[1]) == "--sweep") {
+        uint64_t games = strtoull(argv[2], nullptr, 10);
+        vector<SweepAxis> axes;
+        size_t randomCandidates = 0;
+        Difficulty diff = MEDIUM;
+        uint64_t seed = 1;
+        double target = 0.5;
+        for (int i = 3; i < argc; i++) {
+            string arg = argv[i];
+            if (arg[0] == '-' && i + 1 >= argc) {
+                cout << "Missing value after " << arg << "\n";
+                return 1;
             }
-            else {
-                int amount;
-                cout << "How much food to sell: ";
-                cin >> amount;
-                market.sellFood(amount, food, gold);
-            }
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            break;
-        }
-        case 6: {
-            buildings.buildFarm(wood, stone);
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            break;
-        }
-        case 7: {
-            buildings.buildBarracks(wood, stone);
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            this_thread::sleep_for(std::chrono::seconds(2));
-            cout << "---------------------------\n";
-            randomEvent();
-            break;
-        }
-        case 8: {
-            int amount, term;
-            cout << "Enter loan amount: ";
-            cin >> amount;
-            cout << "Repayment term (turns): ";
-            cin >> term;
-            bank.giveLoan(amount, gold);
-            cout << "--------------------------\n";
-            void produceResources(Inventory<int>&food, Inventory<int>&iron);
-            turn++;
-            break;
-        }
-        case 0: {
-            int ch;
-            gameOver = true;
-            cout << "Do you want save game?\n";
-            cout << "1. Yes\n0. No\n";
-            cout << "Enter your choice: ";
-            cin >> ch;
-            if (ch == 1) {
-                cout << "Game saved and exited.\n";
+            SweepAxis axis;
+            if (arg == "--random") randomCandidates = strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--difficulty") {
+                if (!parseDifficulty(argv[++i], diff)) return 1;
             }
-            else if (ch == 0) {
-                cout << "Game not saved and exited.\n";
+            else if (arg == "--seed") seed = strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--target") target = atof(argv[++i]);
+            else if (SweepAxis::parse(arg, axis)) axes.push_back(axis);
+            else {
+                cout << "Unknown sweep axis " << arg << "; parameters are:";
+                for (int p = 0; p < BALANCE_PARAM_COUNT; p++) {
+                    cout << " " << balanceParamName(static_cast<BalanceParam>(p));
+                }
+                cout << "\n";
+                return 1;
             }
-            
-            break;
-        }
-        default: {
-            cout << "Invalid choice.\n";
-            break;
-        }
-        }
-    }
-
-    bool isGameOver() const {
-        return gameOver;
-    }
-
-    void saveGame() const {
-        ofstream saveFile("stronghold_save.txt");
-        saveFile << turn << "\n";
-        saveFile << static_cast<int>(difficulty) << "\n";
-        saveFile << currentKing->name << "\n";
-        saveFile << currentKing->taxRate << "\n";
-        saveFile << food.get() << "\n";
-        saveFile << gold.get() << "\n";
-        saveFile << wood.get() << "\n";
-        saveFile << stone.get() << "\n";
-        saveFile << iron.get() << "\n";
-        saveFile << weapons.get() << "\n";
-        saveFile << population.getHappiness() << "\n";
-        saveFile << population.getPeasants() << "\n";
-        saveFile << population.getTotal() << "\n";
-        saveFile.close();
-        cout << "Game saved.\n";
-    }
-
-    void loadGame() {
-        ifstream saveFile("stronghold_save.txt");
-        if (saveFile) {
-            int diff;
-            string kingName;
-            int taxRate, f, g, w, s, i, wp, happiness, peasants, totalPop;
-            saveFile >> turn;
-            saveFile >> diff;
-            difficulty = static_cast<Difficulty>(diff);
-            saveFile.ignore();
-            getline(saveFile, kingName);
-            saveFile >> taxRate;
-            saveFile >> f >> g >> w >> s >> i >> wp >> happiness >> peasants >> totalPop;
-            delete currentKing;
-            currentKing = new King(kingName);
-            currentKing->setTaxRate(taxRate);
-            int merchants = totalPop * 0.2;  // Adjust these ratios as needed
-            int nobility = totalPop * 0.1;
-            int soldiers = totalPop - peasants - merchants - nobility;
-
-            population = Population(peasants, merchants, nobility, soldiers, happiness);
-            food.set(f);
-            gold.set(g);
-            wood.set(w);
-            stone.set(s);
-            iron.set(i);
-            weapons.set(wp);
-
-            cout << "Game loaded.\n";
-        }
-        else {
-            cout << "No save file found.\n";
         }
+        if (games == 0 || axes.empty()) {
+            cout << "A sweep needs games and at least one axis\n";
+            return 1;
+        }
+        BalanceSweep sweep(diff, games, seed);
+        auto start = chrono::steady_clock::now();
+        vector<SweepPoint> points = randomCandidates > 0
+            ? sweep.randomSearch(BalanceParams(), axes, randomCandidates)
+            : sweep.grid(BalanceParams(), axes);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        BalanceSweep::writeCsv(cout, axes, points);
+        cerr << points.size() << " candidates x " << games << " games on " << sweep.threadCount()
+            << " threads in " << seconds << "s\n";
+        cerr << sweep.candidatesReused() << " of " << sweep.candidatesEvaluated()
+            << " candidates repeated an earlier one and reused its games\n";
+        const SweepPoint* best = BalanceSweep::closest(points, target);
+        cerr << "Closest to a " << target * 100 << "% win rate (" << best->winRate() * 100 << "%):";
+        for (size_t a = 0; a < axes.size(); a++) {
+            cerr << " " << balanceParamName(axes[a].param) << "=" << best->params.get(axes[a].param);
+        }
+        cerr << "\n";
+        return 0;
+    }
+
+#ifdef __linux__
+    // stronghold --serve <socket path | tcp port> [threads] [autosave file] [sessions]
+    // Hosts games for network clients until interrupted
+    if (argc >= 3 && string(argv[1]) == "--serve") {
+        string address = argv[2];
+        GameServer server(argc >= 4 ? atoi(argv[3]) : 0);
+        unique_ptr<Autosaver> autosave;
+        if (argc >= 5) {
+            autosave.reset(new Autosaver(argv[4], argc >= 6 ? strtoull(argv[5], nullptr, 10) : 16384));
+            server.autosaveTo(autosave.get());
+        }
+        bool port = address.find_first_not_of("0123456789") == string::npos;
+        bool listening = port ? server.listenTcp(static_cast<uint16_t>(atoi(address.c_str())))
+            : server.listenUnix(address);
+        if (!listening) {
+            cout << "Could not listen on " << address << "\n";
+            return 1;
+        }
+        cout << "Serving on " << address << " with " << server.threadCount() << " threads\n";
+        runningServer = &server;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+        signal(SIGPIPE, SIG_IGN);
+        server.run();
+        runningServer = nullptr;
+        const ServerStats& stats = server.getStats();
+        cout << "Connections: " << stats.connections << "  Actions: " << stats.actions
+            << "  Batches: " << stats.batches << "\n";
+        if (autosave) {
+            autosave->sync();
+            cout << "Autosaved " << autosave->recordsWritten() << " snapshots in " << autosave->roundsWritten()
+                << " rounds\n";
+        }
+        return 0;
+    }
+
+    // stronghold --load-test <socket path | tcp port> [sessions] [seconds] [actions/sec per session]
+    //                        [connections]
+    if (argc >= 3 && string(argv[1]) == "--load-test") {
+        LoadTestConfig config;
+        config.address = argv[2];
+        if (argc >= 4) config.sessions = atoi(argv[3]);
+        if (argc >= 5) config.seconds = atof(argv[4]);
+        if (argc >= 6) config.actionsPerSecond = atof(argv[5]);
+        if (argc >= 7) config.connections = atoi(argv[6]);
+        signal(SIGPIPE, SIG_IGN);
+        LoadTestReport report;
+        bool ok = LoadClient::run(config, report);
+        if (!ok && report.actions == 0) {
+            cout << "Could not reach a server on " << config.address << "\n";
+            return 1;
+        }
+        cout << config.sessions << " sessions over " << config.connections << " connections at "
+            << config.actionsPerSecond << " actions/s each\n";
+        report.print(cout);
+        return ok ? 0 : 1;
+    }
+#endif
+
+    // stronghold --world <width> <height> [difficulty 1-3] [seed]
+    if (argc >= 4 && string(argv[1]) == "--world") {
+        size_t width = strtoull(argv[2], nullptr, 10);
+        size_t height = strtoull(argv[3], nullptr, 10);
+        Difficulty diff = MEDIUM;
+        if (argc >= 5 && !parseDifficulty(argv[4], diff)) return 1;
+        uint64_t seed = argc >= 6 ? strtoull(argv[5], nullptr, 10) : 1;
+        if (width == 0 || height == 0) {
+            cout << "World needs at least one kingdom\n";
+            return 1;
+        }
+        World world(width, height, diff, seed);
+        auto start = chrono::steady_clock::now();
+        WorldStats stats = world.run(INT_MAX);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "Simulated " << world.size() << " kingdoms on " << world.threadCount() << " threads in "
+            << seconds << "s\n";
+        stats.print(cout);
+        uint64_t outcomes[OUTCOME_COUNT] = {};
+        for (size_t i = 0; i < world.size(); i++) outcomes[world.kingdom(i).getOutcome()]++;
+        for (int i = 0; i < OUTCOME_COUNT; i++) {
+            if (outcomes[i] == 0) continue;
+            cout << "  " << outcomeName(static_cast<GameOutcome>(i)) << ": " << outcomes[i] << "\n";
+        }
+        return 0;
+    }
+
+    // stronghold --battle <attackers> <defenders> [seed]
+    if (argc >= 4 && string(argv[1]) == "--battle") {
+        int attackers = atoi(argv[2]);
+        int defenders = atoi(argv[3]);
+        uint64_t seed = argc >= 5 ? strtoull(argv[4], nullptr, 10) : 1;
+        // Half of each army is armed; morale as for a fresh kingdom
+        Army attacker(attackers, attackers / 2, 60);
+        Army defender(defenders, defenders / 2, 60);
+        Battlefield field;
+        auto start = chrono::steady_clock::now();
+        BattleResult result = fightBattle(field, attacker, attacker.getWeapons(),
+            defender, defender.getWeapons(), seed);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "Battle of " << attackers << " vs " << defenders << " on " << field.threadCount()
+            << " threads: " << result.steps << " steps in " << seconds * 1000 << " ms\n";
+        const char* sides[2] = { "Attacker", "Defender" };
+        for (int s = 0; s < 2; s++) {
+            cout << sides[s] << ": " << result.killed[s] << " killed, " << result.routed[s] << " routed, "
+                << result.standing[s] << " standing\n";
+        }
+        cout << (result.winner < 0 ? "Draw" : string(sides[result.winner]) + " wins") << "\n";
+        return 0;
+    }
+
+    // stronghold --autoplay [difficulty 1-3] [decisions per second]
+    if (argc >= 2 && string(argv[1]) == "--autoplay") {
+        Difficulty diff = MEDIUM;
+        if (argc >= 3 && !parseDifficulty(argv[2], diff)) return 1;
+        MctsConfig config;
+        if (argc >= 4) config.decisionsPerSecond = atof(argv[3]);
+        MctsPlayer advisor(config);
+        Kingdom game(diff, static_cast<uint64_t>(time(0)));
+        narrator().setPaced(false);
+        game.play(advisor);
+        game.showStatus();
+        cout << "Outcome: " << outcomeName(game.getOutcome()) << " on turn " << game.turn << "\n";
+        cout << "Transposition hits: " << advisor.cacheHitRate() * 100.0 << "% of "
+             << advisor.cacheProbes() << " leaf positions\n";
+        return 0;
     }
-};
-
-class Disasters {
-public:
-    static void applyDisaster(Kingdom& kingdom, const string& disasterName);
-};
-
-void Disasters::applyDisaster(Kingdom& kingdom, const string& disasterName) {
-    cout << "DISASTER: " << disasterName << " has struck the kingdom!\n";
-
-    int totalPop = kingdom.population.getTotal();
-    int peasantsLoss = static_cast<int>(totalPop * 0.2 * 0.7);
-    int merchantsLoss = static_cast<int>(totalPop * 0.2 * 0.15);
-    int nobilityLoss = static_cast<int>(totalPop * 0.2 * 0.1);
-    int soldiersLoss = static_cast<int>(totalPop * 0.2 * 0.05);
-
-    kingdom.population.removePeasants(peasantsLoss);
-
-    kingdom.food.set(static_cast<int>(kingdom.food.get() * 0.8));
-    kingdom.gold.set(static_cast<int>(kingdom.gold.get() * 0.8));
-    kingdom.wood.set(static_cast<int>(kingdom.wood.get() * 0.8));
-    kingdom.stone.set(static_cast<int>(kingdom.stone.get() * 0.8));
-    kingdom.iron.set(static_cast<int>(kingdom.iron.get() * 0.8));
-    kingdom.weapons.set(static_cast<int>(kingdom.weapons.get() * 0.8));
-    kingdom.population.updateHappiness(-20);
-
-    if (disasterName == "Earthquake") { 
-        cout << "Buildings damaged! Resources lost!\n";
-    }
-    else if (disasterName == "Famine") {
-        cout << "Crops failed! Food halved!\n";
-    }
-    else if (disasterName == "Flood") {
-        cout << "Floods destroyed resources!\n";
-    }
-    cout << "20% of resources and some population lost due to the disaster.\n";
-}
-
-int main() {
-    srand(time(0));
 
     cout << " ===== WELCOME TO STRONGHOLD KINGDOM SIMULATOR =====\n\n";
     cout << "Choose difficulty level:\n";
     cout << "1. Easy\n2. Medium\n3. Hard\n";
-    cout << "Enter choice: ";
-    int diffChoice;
-    cin >> diffChoice;
+    int diffChoice = 0;
+    while (true) {
+        cout << "Enter choice: ";
+        if (cin >> diffChoice && isDifficulty(diffChoice - 1)) break;
+        if (cin.eof()) return 0;
+        cin.clear();
+        cin.ignore(INT_MAX, '\n');
+        cout << "Please choose 1, 2 or 3.\n";
+    }
     Difficulty diff = static_cast<Difficulty>(diffChoice - 1);
 
-    Kingdom game(diff);
+    Kingdom game(diff, static_cast<uint64_t>(time(0)));
+    ActionLog actionLog(diff, game.rng.getSeed());
+    actionLog.attach("stronghold_actions.log");
+    game.record(&actionLog);
 
-    while (!game.isGameOver()) {
-        game.playerTurn();
+    {
+        // Restore with Kingdom::loadBinary("stronghold_autosave.bin")
+        Autosaver autosave("stronghold_autosave.bin", 1);
+        StatusRenderer display(cout);
+        ConsoleActionSource console;
+        while (!game.isGameOver()) {
+            game.playerTurn(console, display);
+            autosave.capture(0, game);
+        }
+        // The final stats; checkGameOver leaves drawing them to the caller
+        display.render(game);
     }
+    if (game.wantsSave()) game.saveGame();
 
     cout << "Thanks for playing!\n";
     system("pause>0");
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,195 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <functional>
+#include <cstdlib>
+#include <cstdint>
+using namespace std;
+
+// Small stand-in for Google Benchmark: each case runs its body with a growing
+// iteration count until it takes at least minTime, then reports time per
+// iteration and items per second. Results are written in Google Benchmark's
+// JSON shape and can be compared against a saved baseline.
+class BenchState {
+private:
+    uint64_t iterations;
+    uint64_t items;
+    int64_t argument;
+    chrono::steady_clock::time_point start;
+    double pausedSeconds;
+    chrono::steady_clock::time_point pauseStart;
+public:
+    BenchState(uint64_t n, int64_t arg) : iterations(n), items(0), argument(arg), pausedSeconds(0.0) {}
+
+    uint64_t maxIterations() const { return iterations; }
+    int64_t arg() const { return argument; }
+
+    void setItemsProcessed(uint64_t n) { items = n; }
+    uint64_t itemsProcessed() const { return items; }
+
+    // Excludes setup work inside the timed body
+    void pauseTiming() { pauseStart = chrono::steady_clock::now(); }
+    void resumeTiming() {
+        pausedSeconds += chrono::duration<double>(chrono::steady_clock::now() - pauseStart).count();
+    }
+    double paused() const { return pausedSeconds; }
+};
+
+struct BenchResult {
+    string name;
+    uint64_t iterations;
+    double nanosecondsPerIteration;
+    double itemsPerSecond;
+};
+
+class BenchRegistry {
+private:
+    struct Case {
+        string name;
+        function<void(BenchState&)> body;
+        int64_t argument;
+    };
+    vector<Case> cases;
+
+public:
+    static BenchRegistry& instance() {
+        static BenchRegistry registry;
+        return registry;
+    }
+
+    void add(const string& name, function<void(BenchState&)> body, int64_t argument) {
+        Case c;
+        c.name = name;
+        c.body = body;
+        c.argument = argument;
+        cases.push_back(c);
+    }
+
+    vector<BenchResult> run(const string& filter, double minTime) const {
+        vector<BenchResult> results;
+        for (size_t i = 0; i < cases.size(); i++) {
+            const Case& c = cases[i];
+            if (!filter.empty() && c.name.find(filter) == string::npos) continue;
+            uint64_t n = 1;
+            while (true) {
+                BenchState state(n, c.argument);
+                auto begin = chrono::steady_clock::now();
+                c.body(state);
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count() - state.paused();
+                if (seconds >= minTime || n >= (1ULL << 40)) {
+                    BenchResult r;
+                    r.name = c.name;
+                    r.iterations = n;
+                    r.nanosecondsPerIteration = seconds * 1e9 / n;
+                    r.itemsPerSecond = seconds > 0 ? state.itemsProcessed() / seconds : 0.0;
+                    results.push_back(r);
+                    cout << r.name << "  " << r.iterations << " iterations  " << r.nanosecondsPerIteration
+                        << " ns/iter  " << r.itemsPerSecond << " items/s\n";
+                    break;
+                }
+                double scale = seconds > 0 ? minTime / seconds * 1.4 : 10.0;
+                if (scale > 10.0) scale = 10.0;
+                if (scale < 2.0) scale = 2.0;
+                n = static_cast<uint64_t>(n * scale);
+            }
+        }
+        return results;
+    }
+};
+
+struct BenchRegistrar {
+    BenchRegistrar(const string& name, function<void(BenchState&)> body, const vector<int64_t>& args) {
+        if (args.empty()) {
+            BenchRegistry::instance().add(name, body, 0);
+        }
+        for (size_t i = 0; i < args.size(); i++) {
+            BenchRegistry::instance().add(name + "/" + to_string(args[i]), body, args[i]);
+        }
+    }
+};
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+// BENCHMARK_ARGS(function, {arg, ...}) registers one case per argument
+#define BENCHMARK_ARGS(fn, ...) \
+    static BenchRegistrar BENCH_CONCAT(benchRegistrar, __LINE__)(#fn, fn, vector<int64_t> __VA_ARGS__)
+
+inline void writeBenchJson(ostream& out, const vector<BenchResult>& results) {
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"real_time\": " << r.nanosecondsPerIteration << ", \"time_unit\": \"ns\""
+            << ", \"items_per_second\": " << r.itemsPerSecond << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+// Reads name -> real_time back from a file written by writeBenchJson
+inline map<string, double> readBenchJson(istream& in) {
+    map<string, double> times;
+    string line;
+    while (getline(in, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t time = line.find("\"real_time\": ");
+        if (name == string::npos || time == string::npos) continue;
+        name += 9;
+        times[line.substr(name, line.find('"', name) - name)] = atof(line.c_str() + time + 13);
+    }
+    return times;
+}
+
+// Usage: <bench> [--benchmark_filter=<substr>] [--benchmark_min_time=<seconds>]
+//                [--benchmark_out=<file.json>] [--benchmark_baseline=<file.json>]
+//                [--benchmark_tolerance=<fraction>]
+// With a baseline, exits with status 1 if any case got slower than allowed.
+inline int runBenchmarks(int argc, char* argv[]) {
+    string filter, outPath, baselinePath;
+    double minTime = 0.5;
+    double tolerance = 0.10;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        if (a.rfind("--benchmark_filter=", 0) == 0) filter = a.substr(19);
+        else if (a.rfind("--benchmark_min_time=", 0) == 0) minTime = atof(a.c_str() + 21);
+        else if (a.rfind("--benchmark_out=", 0) == 0) outPath = a.substr(16);
+        else if (a.rfind("--benchmark_baseline=", 0) == 0) baselinePath = a.substr(21);
+        else if (a.rfind("--benchmark_tolerance=", 0) == 0) tolerance = atof(a.c_str() + 22);
+        else {
+            cerr << "Unknown option " << a << "\n";
+            return 2;
+        }
+    }
+
+    vector<BenchResult> results = BenchRegistry::instance().run(filter, minTime);
+
+    if (!outPath.empty()) {
+        ofstream out(outPath);
+        writeBenchJson(out, results);
+    }
+
+    int status = 0;
+    if (!baselinePath.empty()) {
+        ifstream in(baselinePath);
+        if (!in) {
+            cerr << "Could not read baseline " << baselinePath << "\n";
+            return 2;
+        }
+        map<string, double> baseline = readBenchJson(in);
+        for (size_t i = 0; i < results.size(); i++) {
+            map<string, double>::const_iterator it = baseline.find(results[i].name);
+            if (it == baseline.end() || it->second <= 0) continue;
+            double change = results[i].nanosecondsPerIteration / it->second - 1.0;
+            if (change > tolerance) {
+                cout << "REGRESSION " << results[i].name << ": " << change * 100 << "% slower than baseline\n";
+                status = 1;
+            }
+        }
+    }
+    return status;
+}
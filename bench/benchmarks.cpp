@@ -0,0 +1,321 @@
+#include "Benchmark.h"
+#include "../src/Kingdom.h"
+#include "../src/ActionSource.h"
+#include "../src/KingdomArchive.h"
+#include "../src/KingdomBatch.h"
+#include "../src/MonteCarloRunner.h"
+#include "../src/Telemetry.h"
+#include "../src/CheckpointStream.h"
+#include "../src/MctsPlayer.h"
+#include "../src/World.h"
+#include "../src/OrderBook.h"
+#include "../src/LoanLedger.h"
+#include "../src/Battlefield.h"
+#include "../src/StatusRenderer.h"
+#include "../src/Autosave.h"
+#include "../src/Narrator.h"
+#include <cstdio>
+
+// Turns per second of a kingdom that only waits (arg = difficulty)
+static void BM_Turns(BenchState& state) {
+    Difficulty diff = static_cast<Difficulty>(state.arg());
+    uint64_t turns = 0;
+    uint64_t game = 0;
+    while (turns < state.maxIterations()) {
+        Kingdom kingdom(diff, ++game);
+        while (!kingdom.isGameOver() && turns < state.maxIterations()) {
+            kingdom.step(PlayerAction(ACTION_WAIT));
+            turns++;
+        }
+    }
+    state.setItemsProcessed(turns);
+}
+BENCHMARK_ARGS(BM_Turns, { EASY, MEDIUM, HARD });
+
+// Turns per second of idle games played out over up to arg turns, one
+// nextTurn at a time
+static void BM_LongHorizon(BenchState& state) {
+    BalanceParams balance;
+    balance.winTurn = static_cast<int>(state.arg()) + 1;
+    uint64_t turns = 0;
+    uint64_t game = 0;
+    while (turns < state.maxIterations()) {
+        Kingdom kingdom(MEDIUM, ++game);
+        kingdom.useBalance(&balance);
+        while (!kingdom.isGameOver() && turns < state.maxIterations()) {
+            kingdom.nextTurn();
+            turns++;
+        }
+    }
+    state.setItemsProcessed(turns);
+}
+BENCHMARK_ARGS(BM_LongHorizon, { 1000 });
+
+// Whole games per second on one thread with the random policy (arg = difficulty)
+static void BM_Games(BenchState& state) {
+    Difficulty diff = static_cast<Difficulty>(state.arg());
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        Kingdom kingdom(diff, Random::mixSeed(7, i));
+        PolicyActionSource player(randomPolicy, i);
+        kingdom.play(player);
+    }
+    state.setItemsProcessed(state.maxIterations());
+}
+BENCHMARK_ARGS(BM_Games, { EASY, MEDIUM, HARD });
+
+// Games per second through the parallel runner, 4096 games per run (arg = difficulty)
+static void BM_MonteCarlo(BenchState& state) {
+    static MonteCarloRunner runner;
+    Difficulty diff = static_cast<Difficulty>(state.arg());
+    uint64_t games = 0;
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        games += runner.run(diff, 4096, i).games;
+    }
+    state.setItemsProcessed(games);
+}
+BENCHMARK_ARGS(BM_MonteCarlo, { EASY, MEDIUM, HARD });
+
+// Games per second through the runner with every turn recorded to a
+// telemetry file, 4096 games per run; compare with BM_MonteCarlo/1
+static void BM_MonteCarloTelemetry(BenchState& state) {
+    static MonteCarloRunner runner;
+    TelemetryWriter telemetry;
+    telemetry.open("bench_telemetry.bin");
+    uint64_t games = 0;
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        games += runner.run(MEDIUM, 4096, i, randomPolicy, &telemetry).games;
+    }
+    telemetry.close();
+    remove("bench_telemetry.bin");
+    state.setItemsProcessed(games);
+}
+BENCHMARK_ARGS(BM_MonteCarloTelemetry, {});
+
+// The same with the full state of every turn checkpointed instead
+static void BM_MonteCarloCheckpoints(BenchState& state) {
+    static MonteCarloRunner runner;
+    CheckpointWriter checkpoints;
+    checkpoints.open("bench_checkpoints.bin");
+    uint64_t games = 0;
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        games += runner.run(MEDIUM, 4096, i, randomPolicy, nullptr, &checkpoints).games;
+    }
+    checkpoints.close();
+    remove("bench_checkpoints.bin");
+    state.setItemsProcessed(games);
+}
+BENCHMARK_ARGS(BM_MonteCarloCheckpoints, {});
+
+// Fork-and-restore round trips per second, as search and rollback use them
+static void BM_ForkRestore(BenchState& state) {
+    Kingdom kingdom(HARD, 3);
+    Kingdom scratch = kingdom.fork();
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        scratch = kingdom;
+        scratch.step(PlayerAction(ACTION_WAIT));
+    }
+    state.setItemsProcessed(state.maxIterations());
+}
+BENCHMARK_ARGS(BM_ForkRestore, {});
+
+// Population cohort updates per second across many kingdoms (arg = kingdoms)
+static void BM_Demography(BenchState& state) {
+    vector<Population> populations(static_cast<size_t>(state.arg()), Population(100, 20, 10, 30, 70));
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        for (size_t k = 0; k < populations.size(); k++) populations[k].advance();
+    }
+    state.setItemsProcessed(state.maxIterations() * populations.size());
+}
+BENCHMARK_ARGS(BM_Demography, { 100000 });
+
+// Kingdom-turns per second of the batch economy kernel (arg = batch size)
+static void BM_BatchEconomy(BenchState& state) {
+    size_t count = static_cast<size_t>(state.arg());
+    KingdomBatch batch(count);
+    Kingdom kingdom(MEDIUM);
+    for (size_t i = 0; i < count; i++) batch.load(i, kingdom);
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        batch.advanceEconomy();
+        batch.advanceMarket();
+    }
+    state.setItemsProcessed(state.maxIterations() * count);
+}
+BENCHMARK_ARGS(BM_BatchEconomy, { 1024, 16384, 262144 });
+
+// Loan-turns per second of interest accrual over contiguous loan slots (arg = loans)
+static void BM_LoanAccrual(BenchState& state) {
+    size_t count = static_cast<size_t>(state.arg());
+    vector<float> balance(count), rate(count), payment(count);
+    vector<int32_t> installments(count / MAX_LOANS);
+    for (size_t i = 0; i < count; i++) {
+        rate[i] = 0.02f + 0.01f * (i % 8);
+        payment[i] = LoanLedger::schedulePayment(500.0f, rate[i], 1 + i % MAX_LOAN_TERM);
+    }
+    for (uint64_t n = 0; n < state.maxIterations(); n++) {
+        // Refill so balances stay in range however many turns run
+        if (n % 16 == 0) fill(balance.begin(), balance.end(), 500.0f);
+        LoanLedger::accrue(balance.data(), rate.data(), payment.data(), installments.data(), installments.size());
+    }
+    state.setItemsProcessed(state.maxIterations() * count);
+}
+BENCHMARK_ARGS(BM_LoanAccrual, { 65536 });
+
+// Kingdom-turns per second of world ticks, restarting the world when it ends (arg = kingdoms)
+static void BM_WorldTick(BenchState& state) {
+    size_t side = 1;
+    while (side * side < static_cast<size_t>(state.arg())) side++;
+    uint64_t turns = 0;
+    uint64_t ticks = 0;
+    uint64_t run = 0;
+    while (ticks < state.maxIterations()) {
+        state.pauseTiming();
+        World world(side, side, MEDIUM, ++run);
+        state.resumeTiming();
+        while (world.aliveCount() > 0 && ticks < state.maxIterations()) {
+            turns += world.tick().turns;
+            ticks++;
+        }
+    }
+    state.setItemsProcessed(turns);
+}
+BENCHMARK_ARGS(BM_WorldTick, { 4096, 65536 });
+
+// Orders per second through submit + batch auction (arg = orders per auction)
+static void BM_OrderBookAuction(BenchState& state) {
+    size_t count = static_cast<size_t>(state.arg());
+    Random rng(17);
+    vector<BookOrder> orders(count);
+    for (size_t i = 0; i < count; i++) {
+        orders[i].side = rng.next(2) ? SIDE_BUY : SIDE_SELL;
+        orders[i].price = 1 + rng.next(60);
+        orders[i].quantity = 1 + rng.next(100);
+    }
+    OrderBook book;
+    for (uint64_t n = 0; n < state.maxIterations(); n++) {
+        book.reset();
+        for (size_t i = 0; i < count; i++) {
+            book.submit(orders[i].side, static_cast<uint32_t>(i), orders[i].price, orders[i].quantity);
+        }
+        book.clear(30);
+    }
+    state.setItemsProcessed(state.maxIterations() * count);
+}
+BENCHMARK_ARGS(BM_OrderBookAuction, { 1024, 1048576 });
+
+// Unit-steps per second of a tactical battle fought to the end (arg = soldiers per side)
+static void BM_Battle(BenchState& state) {
+    int soldiers = static_cast<int>(state.arg());
+    Battlefield field;
+    uint64_t unitSteps = 0;
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        field.reset(i + 1);
+        field.deploy(0, soldiers, soldiers / 2, 60);
+        field.deploy(1, soldiers, soldiers / 2, 60);
+        unitSteps += static_cast<uint64_t>(field.run().steps) * soldiers * 2;
+    }
+    state.setItemsProcessed(unitSteps);
+}
+BENCHMARK_ARGS(BM_Battle, { 1000, 10000 });
+
+// Kingdoms per second written to a binary archive (arg = kingdoms per archive)
+static void BM_SaveArchive(BenchState& state) {
+    size_t count = static_cast<size_t>(state.arg());
+    Kingdom kingdom(HARD, 3);
+    vector<KingdomRecord> records(count, KingdomRecord::capture(kingdom));
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        KingdomArchiveWriter writer("bench_archive.bin");
+        writer.addAll(records.data(), records.size());
+        writer.close();
+    }
+    remove("bench_archive.bin");
+    state.setItemsProcessed(state.maxIterations() * count);
+}
+BENCHMARK_ARGS(BM_SaveArchive, { 1, 1024, 65536 });
+
+// Kingdoms per second mapped and restored from an archive (arg = kingdoms per archive)
+static void BM_LoadArchive(BenchState& state) {
+    size_t count = static_cast<size_t>(state.arg());
+    Kingdom kingdom(HARD, 3);
+    {
+        KingdomArchiveWriter writer("bench_archive.bin");
+        for (size_t i = 0; i < count; i++) writer.add(kingdom);
+    }
+    Kingdom target(EASY);
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        MappedKingdomArchive archive;
+        archive.open("bench_archive.bin");
+        for (size_t k = 0; k < archive.size(); k++) archive[k].restore(target);
+    }
+    remove("bench_archive.bin");
+    state.setItemsProcessed(state.maxIterations() * count);
+}
+BENCHMARK_ARGS(BM_LoadArchive, { 1, 1024, 65536 });
+
+// Search iterations per second of one MCTS decision, 2000 iterations per tree (arg = threads)
+static void BM_MctsDecision(BenchState& state) {
+    MctsConfig config;
+    config.threads = static_cast<unsigned>(state.arg());
+    config.decisionsPerSecond = 0.01;
+    config.maxIterations = 2000;
+    MctsPlayer player(config);
+    Kingdom kingdom(MEDIUM, 11);
+    uint64_t iterations = 0;
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        player.nextAction(kingdom);
+        iterations += player.iterationsLastDecision();
+    }
+    state.setItemsProcessed(iterations);
+}
+BENCHMARK_ARGS(BM_MctsDecision, { 1, 4 });
+
+// Status panel frames per second, alternating between two turns so each
+// frame redraws the lines that changed
+static void BM_StatusFrame(BenchState& state) {
+    Kingdom before(MEDIUM, 9);
+    Kingdom after = before.fork();
+    after.step(PlayerAction(ACTION_COLLECT_TAXES));
+    ostringstream screen;
+    StatusRenderer display(screen);
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        display.render(i % 2 ? after : before);
+        if (i % 1024 == 0) screen.str("");
+    }
+    state.setItemsProcessed(state.maxIterations());
+}
+BENCHMARK_ARGS(BM_StatusFrame, {});
+
+// Round trips per second of the original text save format
+static void BM_TextSaveLoad(BenchState& state) {
+    Kingdom kingdom(MEDIUM, 5);
+    for (uint64_t i = 0; i < state.maxIterations(); i++) {
+        kingdom.saveGame();
+        kingdom.loadGame();
+    }
+    remove("stronghold_save.txt");
+    state.setItemsProcessed(state.maxIterations());
+}
+BENCHMARK_ARGS(BM_TextSaveLoad, {});
+
+// Autosave captures per second across 10k sessions, with the writer thread
+// persisting a round every 50 ms; this is all the turn loop pays for saving
+static void BM_AutosaveCapture(BenchState& state) {
+    const size_t sessions = 10000;
+    Kingdom kingdom(MEDIUM, 5);
+    {
+        Autosaver autosave("bench_autosave.bin", sessions, 50);
+        for (uint64_t i = 0; i < state.maxIterations(); i++) {
+            autosave.capture(i % sessions, kingdom);
+        }
+        // The final round in the destructor is not part of the turn loop
+        state.pauseTiming();
+    }
+    state.resumeTiming();
+    remove("bench_autosave.bin");
+    state.setItemsProcessed(state.maxIterations());
+}
+BENCHMARK_ARGS(BM_AutosaveCapture, {});
+
+int main(int argc, char* argv[]) {
+    narrator().mute();
+    return runBenchmarks(argc, argv);
+}
@@ -0,0 +1,66 @@
+#include "ActionLog.h"
+#include "Varint.h"
+#include <cstring>
+
+void ActionLog::writeEntry(ostream& out, const PlayerAction& action) {
+    // Any other type would not fit the byte, and could wrap to a real action
+    bool known = action.type >= ACTION_INVALID && action.type <= ACTION_WAIT;
+    out.put(static_cast<char>(known ? action.type : ACTION_INVALID));
+    putVarint(out, zigzag(action.amount));
+    putVarint(out, zigzag(action.option));
+}
+
+void ActionLog::writeHeader(ostream& out, Difficulty diff, uint64_t seed) {
+    out.write("SHLOG1", 6);
+    out.put(static_cast<char>(diff));
+    putVarint(out, seed);
+}
+
+void ActionLog::append(const PlayerAction& action) {
+    actions.push_back(action);
+    if (file.is_open()) {
+        writeEntry(file, action);
+        file.flush();
+    }
+}
+
+bool ActionLog::attach(const string& path) {
+    file.open(path, ios::binary | ios::trunc);
+    if (!file) return false;
+    writeHeader(file, difficulty, seed);
+    for (size_t i = 0; i < actions.size(); i++) {
+        writeEntry(file, actions[i]);
+    }
+    file.flush();
+    return true;
+}
+
+bool ActionLog::save(const string& path) const {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) return false;
+    writeHeader(out, difficulty, seed);
+    for (size_t i = 0; i < actions.size(); i++) {
+        writeEntry(out, actions[i]);
+    }
+    return out.good();
+}
+
+bool ActionLog::load(const string& path) {
+    ifstream in(path, ios::binary);
+    char magic[6];
+    if (!in.read(magic, 6) || memcmp(magic, "SHLOG1", 6) != 0) return false;
+    int diff = in.get();
+    if (diff < EASY || diff > HARD || !getVarint(in, seed)) return false;
+    difficulty = static_cast<Difficulty>(diff);
+    actions.clear();
+    while (true) {
+        int type = in.get();
+        uint64_t amount, option;
+        if (type == EOF || !getVarint(in, amount) || !getVarint(in, option)) break;
+        int code = static_cast<signed char>(type);
+        bool known = code >= ACTION_INVALID && code <= ACTION_WAIT;
+        actions.push_back(PlayerAction(known ? static_cast<ActionType>(code) : ACTION_INVALID,
+            unzigzag(amount), unzigzag(option)));
+    }
+    return true;
+}
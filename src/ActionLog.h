@@ -0,0 +1,36 @@
+#pragma once
+#include "GameTypes.h"
+
+// Append-only record of one game: its difficulty and seed plus every action
+// passed to Kingdom::step. Together they reproduce the game exactly. When
+// attached to a file, each entry is written through as it is appended.
+// Entries are a type byte followed by zigzag varints of amount and option,
+// so a typical action takes 2-4 bytes. Types outside the enum are recorded
+// and read back as ACTION_INVALID.
+class ActionLog {
+private:
+    Difficulty difficulty;
+    uint64_t seed;
+    vector<PlayerAction> actions;
+    ofstream file;
+
+    static void writeEntry(ostream& out, const PlayerAction& action);
+    static void writeHeader(ostream& out, Difficulty diff, uint64_t seed);
+
+public:
+    ActionLog(Difficulty diff = MEDIUM, uint64_t s = 1) : difficulty(diff), seed(s) {}
+
+    Difficulty getDifficulty() const { return difficulty; }
+    uint64_t getSeed() const { return seed; }
+    size_t size() const { return actions.size(); }
+    const PlayerAction& operator[](size_t i) const { return actions[i]; }
+
+    void append(const PlayerAction& action);
+
+    // Writes the log so far to path and keeps appending to it
+    bool attach(const string& path);
+    bool save(const string& path) const;
+
+    // Reads a log; a truncated last entry (e.g. after a crash) is dropped
+    bool load(const string& path);
+};
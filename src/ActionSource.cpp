@@ -0,0 +1,71 @@
+#include "ActionSource.h"
+#include <climits>
+
+PlayerAction ConsoleActionSource::nextAction(const Kingdom&) {
+    cout << "\n=== ACTIONS ===\n";
+    cout << "1. Collect Taxes\n";
+    cout << "2. Change Tax Rate\n";
+    cout << "3. Recruit Soldiers\n";
+    cout << "4. Train Soldiers\n";
+    cout << "5. Buy/Sell Food\n";
+    cout << "6. Build Farm\n";
+    cout << "7. Build Barracks\n";
+    cout << "8. Take Loan\n";
+    cout << "0. Quit Game\n";
+
+    int choice;
+    cout << "\nChoose action: ";
+    if (!(cin >> choice)) {
+        // End of input quits; any other non-number is not on the menu
+        choice = cin.eof() ? ACTION_QUIT : ACTION_INVALID;
+        cin.clear();
+        cin.ignore(INT_MAX, '\n');
+    }
+    cout << "--------------------------\n";
+
+    // Wait is not on the menu either
+    bool listed = choice >= ACTION_QUIT && choice < ACTION_WAIT;
+    PlayerAction action(listed ? static_cast<ActionType>(choice) : ACTION_INVALID);
+    switch (action.type) {
+    case ACTION_SET_TAX_RATE:
+        cout << "Enter new tax rate (5-50): ";
+        cin >> action.amount;
+        break;
+    case ACTION_RECRUIT:
+        cout << "Enter number of soldiers you want to recruit: ";
+        cin >> action.amount;
+        break;
+    case ACTION_TRADE_FOOD:
+        cout << "1. Buy Food\n2. Sell Food\n";
+        cin >> action.option;
+        cout << (action.option == 1 ? "How much food to buy: " : "How much food to sell: ");
+        cin >> action.amount;
+        break;
+    case ACTION_TAKE_LOAN:
+        cout << "Enter loan amount: ";
+        cin >> action.amount;
+        cout << "Repayment term (turns): ";
+        cin >> action.option;
+        break;
+    case ACTION_QUIT:
+        cout << "Do you want save game?\n";
+        cout << "1. Yes\n0. No\n";
+        cout << "Enter your choice: ";
+        cin >> action.option;
+        break;
+    default:
+        break;
+    }
+    return action;
+}
+
+PlayerAction randomPolicy(const Kingdom&, Random& rng) {
+    ActionType type = static_cast<ActionType>(1 + rng.next(8));
+    switch (type) {
+    case ACTION_SET_TAX_RATE: return PlayerAction(type, 5 + rng.next(46));
+    case ACTION_RECRUIT: return PlayerAction(type, rng.next(20));
+    case ACTION_TRADE_FOOD: return PlayerAction(type, 10 + rng.next(200), 1 + rng.next(2));
+    case ACTION_TAKE_LOAN: return PlayerAction(type, 100 + rng.next(900), 1 + rng.next(10));
+    default: return PlayerAction(type);
+    }
+}
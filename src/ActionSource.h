@@ -0,0 +1,54 @@
+#pragma once
+#include "GameTypes.h"
+#include "Random.h"
+#include <functional>
+
+class Kingdom;
+
+// Supplies player actions to Kingdom::playerTurn / Kingdom::play
+class ActionSource {
+public:
+    virtual PlayerAction nextAction(const Kingdom& kingdom) = 0;
+    virtual ~ActionSource() {}
+};
+
+// Interactive source: shows the action menu and reads the choice from cin
+class ConsoleActionSource : public ActionSource {
+public:
+    PlayerAction nextAction(const Kingdom& kingdom) override;
+};
+
+// Replays a fixed list of actions, then waits out the remaining turns
+class ScriptedActionSource : public ActionSource {
+private:
+    vector<PlayerAction> script;
+    size_t position;
+public:
+    ScriptedActionSource(const vector<PlayerAction>& actions) : script(actions), position(0) {}
+
+    PlayerAction nextAction(const Kingdom&) override {
+        if (position < script.size()) {
+            return script[position++];
+        }
+        return PlayerAction(ACTION_WAIT);
+    }
+};
+
+// Feeds Kingdom::play from a policy function with its own random stream
+class PolicyActionSource : public ActionSource {
+public:
+    typedef function<PlayerAction(const Kingdom&, Random&)> Policy;
+
+private:
+    Policy policy;
+    Random rng;
+public:
+    PolicyActionSource(const Policy& p, uint64_t seed) : policy(p), rng(seed) {}
+
+    PlayerAction nextAction(const Kingdom& kingdom) override {
+        return policy(kingdom, rng);
+    }
+};
+
+// Default Monte Carlo player: any menu action except quitting, with random amounts
+PlayerAction randomPolicy(const Kingdom& kingdom, Random& rng);
@@ -0,0 +1,84 @@
+#pragma once
+#include "Narrator.h"
+#include "Random.h"
+#include "Inventory.h"
+#include "Population.h"
+#include "BalanceParams.h"
+
+struct KingdomRecord;
+class Battlefield;
+struct BattleResult;
+
+class Army {
+private:
+    int soldiers;
+    int weapons;
+    int morale;
+    bool inWar;
+    friend struct KingdomRecord;
+public:
+    Army(int s, int w, int m) : soldiers(s), weapons(w), morale(m), inWar(false) {}
+
+    int getSoldiers() const {
+        return soldiers;
+    }
+
+    int getWeapons() const {
+        return weapons;
+    }
+
+    int getMorale() const {
+        return morale;
+    }
+
+    bool isInWar() const {
+        return inWar;
+    }
+
+    void setMorale(int m) {
+        morale = m;
+    }
+
+    void addSoldiers(int count) {
+        soldiers += count;
+        if (soldiers < 0) soldiers = 0;
+    }
+
+    void recruit(int count, Population& population, const BalanceParams& balance) {
+        if (count > population.getPeasants() * balance.recruitCapPercent / 100) {
+            narrator() << "Cannot recruit more than " << balance.recruitCapPercent << "% of peasant population\n";
+            return;
+        }
+        soldiers += count;
+        population.removePeasants(count);
+        narrator() << "Recruited " << count << " soldiers.\n";
+    }
+
+    void train() {
+        narrator() << "Training soldiers...\n";
+        narrator().pause(300);
+        morale += 10;
+        if (morale > 100) morale = 100;
+        narrator() << "Training complete! Morale +10\n";
+    }
+
+    void paySoldiers(int amount, Inventory<int>& gold) {
+        if (gold.get() < amount) {
+            narrator() << "Not enough gold to pay soldiers\n";
+            return;
+        }
+        gold.remove(amount);
+        morale += 5;
+        narrator() << "Soldiers paid. Morale +5\n";
+    }
+
+    // Attacks enemy on a tactical battlefield, arming as many soldiers as
+    // the kingdom has weapons in stock, and applies both armies' losses (see
+    // fightBattle). Defined in Battlefield.cpp.
+    BattleResult battle(Battlefield& field, const Inventory<int>& armory, Army& enemy, int enemyWeapons,
+        uint64_t seed);
+
+    // Takes the losses and morale swing of side `side` (0 attacker, 1
+    // defender) from a battle it fought
+    void endBattle(const BattleResult& result, int side);
+};
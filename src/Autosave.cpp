@@ -0,0 +1,168 @@
+#include "Autosave.h"
+#include "Kingdom.h"
+#include "KingdomArchive.h"
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+// Slot state word. Buffer fields hold a buffer index plus one, or 0 for none.
+static const uint32_t LATEST = 1u;              // buffer with the newest capture
+static const uint32_t DIRTY = 1u << 1;          // the newest capture is not persisted yet
+static const uint32_t WRITING_SHIFT = 2;        // buffer capture() is filling
+static const uint32_t READING_SHIFT = 4;        // buffer the writer is copying
+static const uint32_t FIELD_MASK = 3u;
+
+// Bytes per write call; a large file goes out in pieces so the scheduler can
+// run the turn loop in between
+static const size_t WRITE_CHUNK = 256 * 1024;
+
+static uint32_t writing(uint32_t state) {
+    return (state >> WRITING_SHIFT) & FIELD_MASK;
+}
+
+static uint32_t reading(uint32_t state) {
+    return (state >> READING_SHIFT) & FIELD_MASK;
+}
+
+Autosaver::Autosaver(const string& file, size_t slotLimit, unsigned intervalMs) :
+    path(file), slotCount(slotLimit), slots(new Slot[slotLimit]), persisted(slotLimit),
+    interval(intervalMs), stopping(false), requested(0), completed(0), rounds(0), records(0), failed(false) {
+    for (size_t i = 0; i < slotCount; i++) slots[i].state.store(0, memory_order_relaxed);
+    writer = thread(&Autosaver::writerLoop, this);
+}
+
+Autosaver::~Autosaver() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+void Autosaver::capture(size_t index, const Kingdom& kingdom) {
+    Slot& slot = slots[index];
+    uint32_t state = slot.state.load(memory_order_acquire);
+    uint32_t target, next;
+    do {
+        // Fill the older buffer unless the writer is reading it; then the
+        // unsaved newest capture is overwritten instead, as it is stale
+        uint32_t latest = state & LATEST;
+        target = reading(state) == (1 - latest) + 1 ? latest : 1 - latest;
+        next = (state & ~(FIELD_MASK << WRITING_SHIFT)) | ((target + 1) << WRITING_SHIFT);
+        if (target == latest) next &= ~DIRTY;
+    } while (!slot.state.compare_exchange_weak(state, next, memory_order_acq_rel, memory_order_acquire));
+
+    slot.buffers[target] = KingdomRecord::capture(kingdom);
+
+    state = next;
+    do {
+        next = (state & ~(LATEST | (FIELD_MASK << WRITING_SHIFT))) | target | DIRTY;
+    } while (!slot.state.compare_exchange_weak(state, next, memory_order_acq_rel, memory_order_acquire));
+}
+
+// Copies a slot's unsaved capture into persisted; false if there is none or
+// it is being overwritten right now (the next round picks it up)
+bool Autosaver::collect(size_t index) {
+    Slot& slot = slots[index];
+    uint32_t state = slot.state.load(memory_order_acquire);
+    uint32_t latest, next;
+    do {
+        if (!(state & DIRTY)) return false;
+        latest = state & LATEST;
+        if (writing(state) == latest + 1) return false;
+        next = (state & ~(DIRTY | (FIELD_MASK << READING_SHIFT))) | ((latest + 1) << READING_SHIFT);
+    } while (!slot.state.compare_exchange_weak(state, next, memory_order_acq_rel, memory_order_acquire));
+
+    persisted[index] = slot.buffers[latest];
+    slot.state.fetch_and(~(FIELD_MASK << READING_SHIFT), memory_order_release);
+    return true;
+}
+
+bool Autosaver::writeFile() {
+    string temporary = path + ".tmp";
+    ArchiveHeader header = ArchiveHeader::make(slotCount);
+#ifdef _WIN32
+    {
+        ofstream file(temporary, ios::binary | ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(persisted.data()), persisted.size() * sizeof(KingdomRecord));
+        if (!file.good()) return false;
+    }
+    remove(path.c_str());
+    return rename(temporary.c_str(), path.c_str()) == 0;
+#else
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = ::write(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+    const char* data = reinterpret_cast<const char*>(persisted.data());
+    size_t remaining = persisted.size() * sizeof(KingdomRecord);
+    while (ok && remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining < WRITE_CHUNK ? remaining : WRITE_CHUNK);
+        ok = written > 0;
+        if (ok) {
+            data += written;
+            remaining -= written;
+        }
+    }
+    // One flush to disk covers every game saved this round
+    ok = ok && fdatasync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) return false;
+
+    // Make the rename itself durable
+    size_t slash = path.rfind('/');
+    string directory = slash == string::npos ? "." : path.substr(0, slash + 1);
+    int dir = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        fsync(dir);
+        ::close(dir);
+    }
+    return true;
+#endif
+}
+
+void Autosaver::writerLoop() {
+#ifdef __linux__
+    // Saving is background work: when cores are short, the turn loop goes first
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        wake.wait_for(guard, interval, [this] { return stopping || requested > completed; });
+        bool finishing = stopping;
+        uint64_t covered = requested;
+        guard.unlock();
+
+        uint64_t collected = 0;
+        for (size_t i = 0; i < slotCount; i++) {
+            if (collect(i)) collected++;
+        }
+        bool ok = collected == 0 || writeFile();
+
+        guard.lock();
+        if (collected > 0) {
+            rounds++;
+            records += collected;
+        }
+        failed = failed || !ok;
+        completed = covered;
+        done.notify_all();
+        if (finishing) return;
+    }
+}
+
+bool Autosaver::sync() {
+    unique_lock<mutex> guard(lock);
+    uint64_t ticket = ++requested;
+    wake.notify_one();
+    done.wait(guard, [&] { return completed >= ticket; });
+    return !failed;
+}
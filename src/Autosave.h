@@ -0,0 +1,88 @@
+#pragma once
+#include "GameTypes.h"
+#include "KingdomRecord.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class Kingdom;
+
+// Keeps an on-disk copy of many kingdoms without stalling the turn loop.
+//
+// Each slot (one game) owns two preallocated KingdomRecords. capture() fills
+// the one the writer thread is not reading and publishes it with a
+// compare-and-swap. It never waits, takes no lock and allocates nothing,
+// so capturing costs about one memcpy of a record. A newer capture simply
+// replaces one the writer has not reached yet.
+//
+// Every interval, or on sync(), the writer collects the slots captured since
+// its last round. It rewrites the whole file as a KingdomArchive, one
+// record per slot in slot order. The file is written to path + ".tmp",
+// made durable with one fdatasync for the whole round, renamed over path,
+// and then the directory is synced. A crash therefore leaves either the
+// previous round or the new one, never a mix. Slots that were never
+// captured are stored as zeroed records (turn 0). Kingdom::loadBinary
+// restores slot 0, and MappedKingdomArchive reads any slot.
+//
+// capture() may run on any thread, provided that each slot has only one
+// capturing thread at a time.
+class Autosaver {
+private:
+    struct alignas(64) Slot {
+        KingdomRecord buffers[2];
+        atomic<uint32_t> state;   // see Autosave.cpp
+    };
+
+    string path;
+    size_t slotCount;
+    unique_ptr<Slot[]> slots;
+    vector<KingdomRecord> persisted;   // the writer's copy of every slot
+    chrono::milliseconds interval;
+    thread writer;
+    mutex lock;
+    condition_variable wake;
+    condition_variable done;
+    bool stopping;
+    uint64_t requested;    // sync() calls so far
+    uint64_t completed;    // sync() calls covered by a finished round
+    uint64_t rounds;
+    uint64_t records;
+    bool failed;
+
+    bool collect(size_t slot);
+    bool writeFile();
+    void writerLoop();
+
+public:
+    Autosaver(const string& file, size_t slotLimit, unsigned intervalMs = 1000);
+
+    // Runs a last round, so every capture made before it is saved
+    ~Autosaver();
+
+    Autosaver(const Autosaver&) = delete;
+    Autosaver& operator=(const Autosaver&) = delete;
+
+    size_t size() const {
+        return slotCount;
+    }
+
+    // Snapshots a kingdom into its slot; call at a turn boundary
+    void capture(size_t slot, const Kingdom& kingdom);
+
+    // Blocks until everything captured before the call is on disk. Meant for
+    // quitting, not for the turn loop. False if a write failed.
+    bool sync();
+
+    // Rounds written, and slot records written by them; exact once the
+    // writer is idle
+    uint64_t roundsWritten() const {
+        return rounds;
+    }
+
+    uint64_t recordsWritten() const {
+        return records;
+    }
+};
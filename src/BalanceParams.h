@@ -0,0 +1,111 @@
+#pragma once
+#include "GameTypes.h"
+#include <cstring>
+
+// Tunable balance constants, addressed by id so sweeps can vary any of them
+enum BalanceParam {
+    BALANCE_RECRUIT_CAP,       // percent of peasants one recruit action may take
+    BALANCE_FARM_WOOD,
+    BALANCE_FARM_STONE,
+    BALANCE_BARRACKS_WOOD,
+    BALANCE_BARRACKS_STONE,
+    BALANCE_FARM_YIELD,        // food per farm per turn
+    BALANCE_MINE_YIELD,        // iron per mine per turn
+    BALANCE_SOLDIER_PAY,       // gold per soldier per turn
+    BALANCE_SELL_RATIO,        // fraction of the buy price paid for sold food
+    BALANCE_WIN_TURN,          // turns to survive for a win
+    BALANCE_PARAM_COUNT
+};
+
+inline const char* balanceParamName(BalanceParam param) {
+    switch (param) {
+    case BALANCE_RECRUIT_CAP: return "recruit_cap";
+    case BALANCE_FARM_WOOD: return "farm_wood";
+    case BALANCE_FARM_STONE: return "farm_stone";
+    case BALANCE_BARRACKS_WOOD: return "barracks_wood";
+    case BALANCE_BARRACKS_STONE: return "barracks_stone";
+    case BALANCE_FARM_YIELD: return "farm_yield";
+    case BALANCE_MINE_YIELD: return "mine_yield";
+    case BALANCE_SOLDIER_PAY: return "soldier_pay";
+    case BALANCE_SELL_RATIO: return "sell_ratio";
+    case BALANCE_WIN_TURN: return "win_turn";
+    default: return "unknown";
+    }
+}
+
+// Looks a parameter up by its name; false if there is none
+inline bool parseBalanceParam(const char* name, BalanceParam& param) {
+    for (int p = 0; p < BALANCE_PARAM_COUNT; p++) {
+        if (strcmp(name, balanceParamName(static_cast<BalanceParam>(p))) == 0) {
+            param = static_cast<BalanceParam>(p);
+            return true;
+        }
+    }
+    return false;
+}
+
+// The game's balance constants. A kingdom points at one set (the standard
+// one unless Kingdom::useBalance says otherwise); the defaults are the
+// values the game has always used.
+struct BalanceParams {
+    int recruitCapPercent;
+    int farmWoodCost;
+    int farmStoneCost;
+    int barracksWoodCost;
+    int barracksStoneCost;
+    int farmYield;
+    int mineYield;
+    int soldierPay;
+    double sellRatio;
+    int winTurn;
+
+    BalanceParams() : recruitCapPercent(10), farmWoodCost(50), farmStoneCost(30),
+        barracksWoodCost(80), barracksStoneCost(50), farmYield(100), mineYield(20),
+        soldierPay(2), sellRatio(0.8), winTurn(20) {}
+
+    static const BalanceParams& standard() {
+        static const BalanceParams params;
+        return params;
+    }
+
+    double get(BalanceParam param) const {
+        switch (param) {
+        case BALANCE_RECRUIT_CAP: return recruitCapPercent;
+        case BALANCE_FARM_WOOD: return farmWoodCost;
+        case BALANCE_FARM_STONE: return farmStoneCost;
+        case BALANCE_BARRACKS_WOOD: return barracksWoodCost;
+        case BALANCE_BARRACKS_STONE: return barracksStoneCost;
+        case BALANCE_FARM_YIELD: return farmYield;
+        case BALANCE_MINE_YIELD: return mineYield;
+        case BALANCE_SOLDIER_PAY: return soldierPay;
+        case BALANCE_SELL_RATIO: return sellRatio;
+        case BALANCE_WIN_TURN: return winTurn;
+        default: return 0.0;
+        }
+    }
+
+    // Integer parameters are rounded to the nearest whole value
+    void set(BalanceParam param, double value) {
+        int whole = static_cast<int>(value < 0 ? value - 0.5 : value + 0.5);
+        switch (param) {
+        case BALANCE_RECRUIT_CAP: recruitCapPercent = whole; break;
+        case BALANCE_FARM_WOOD: farmWoodCost = whole; break;
+        case BALANCE_FARM_STONE: farmStoneCost = whole; break;
+        case BALANCE_BARRACKS_WOOD: barracksWoodCost = whole; break;
+        case BALANCE_BARRACKS_STONE: barracksStoneCost = whole; break;
+        case BALANCE_FARM_YIELD: farmYield = whole; break;
+        case BALANCE_MINE_YIELD: mineYield = whole; break;
+        case BALANCE_SOLDIER_PAY: soldierPay = whole; break;
+        case BALANCE_SELL_RATIO: sellRatio = value; break;
+        case BALANCE_WIN_TURN: winTurn = whole; break;
+        default: break;
+        }
+    }
+
+    bool operator==(const BalanceParams& other) const {
+        for (int p = 0; p < BALANCE_PARAM_COUNT; p++) {
+            if (get(static_cast<BalanceParam>(p)) != other.get(static_cast<BalanceParam>(p))) return false;
+        }
+        return true;
+    }
+};
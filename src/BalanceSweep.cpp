@@ -0,0 +1,111 @@
+#include "BalanceSweep.h"
+#include "Random.h"
+#include "Zobrist.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+bool SweepAxis::parse(const string& spec, SweepAxis& axis) {
+    size_t equals = spec.find('=');
+    if (equals == string::npos) return false;
+    BalanceParam param;
+    if (!parseBalanceParam(spec.substr(0, equals).c_str(), param)) return false;
+    double low, high;
+    int steps = 1;
+    int fields = sscanf(spec.c_str() + equals + 1, "%lf:%lf:%d", &low, &high, &steps);
+    if (fields < 2) return false;
+    axis = SweepAxis(param, low, high, steps);
+    return true;
+}
+
+static uint64_t paramsHash(const BalanceParams& params) {
+    uint64_t hash = 0;
+    for (int p = 0; p < BALANCE_PARAM_COUNT; p++) {
+        double value = params.get(static_cast<BalanceParam>(p));
+        int64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        hash ^= zobristKey(p, bits);
+    }
+    return hash;
+}
+
+SweepPoint BalanceSweep::evaluate(const BalanceParams& params) {
+    lookups++;
+    uint64_t key = paramsHash(params);
+    auto range = playedIndex.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (played[it->second].params == params) {
+            reuses++;
+            return played[it->second];
+        }
+    }
+
+    SweepPoint point;
+    point.params = params;
+    runner.setBalance(params);
+    point.report = runner.run(difficulty, gamesPerCandidate, seed);
+    playedIndex.insert(make_pair(key, played.size()));
+    played.push_back(point);
+    return point;
+}
+
+vector<SweepPoint> BalanceSweep::grid(const BalanceParams& base, const vector<SweepAxis>& axes) {
+    size_t total = 1;
+    for (size_t a = 0; a < axes.size(); a++) total *= axes[a].steps;
+    vector<SweepPoint> points;
+    points.reserve(total);
+    for (size_t index = 0; index < total; index++) {
+        BalanceParams params = base;
+        size_t rest = index;
+        for (size_t a = axes.size(); a-- > 0;) {
+            params.set(axes[a].param, axes[a].value(static_cast<int>(rest % axes[a].steps)));
+            rest /= axes[a].steps;
+        }
+        points.push_back(evaluate(params));
+    }
+    return points;
+}
+
+vector<SweepPoint> BalanceSweep::randomSearch(const BalanceParams& base, const vector<SweepAxis>& axes,
+    size_t count) {
+    vector<SweepPoint> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        BalanceParams params = base;
+        for (size_t a = 0; a < axes.size(); a++) {
+            // Top 53 bits as a fraction in [0, 1)
+            uint64_t raw = Random::at(seed, 0, static_cast<uint32_t>(a), static_cast<uint32_t>(i));
+            double unit = static_cast<double>(raw >> 11) * (1.0 / 9007199254740992.0);
+            params.set(axes[a].param, axes[a].low + (axes[a].high - axes[a].low) * unit);
+        }
+        points.push_back(evaluate(params));
+    }
+    return points;
+}
+
+const SweepPoint* BalanceSweep::closest(const vector<SweepPoint>& points, double targetWinRate) {
+    const SweepPoint* best = nullptr;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!best || fabs(points[i].winRate() - targetWinRate) < fabs(best->winRate() - targetWinRate)) {
+            best = &points[i];
+        }
+    }
+    return best;
+}
+
+void BalanceSweep::writeCsv(ostream& out, const vector<SweepAxis>& axes, const vector<SweepPoint>& points) {
+    for (size_t a = 0; a < axes.size(); a++) out << balanceParamName(axes[a].param) << ",";
+    out << "games,win_rate";
+    for (int o = OUTCOME_WIN + 1; o < OUTCOME_COUNT; o++) out << "," << outcomeName(static_cast<GameOutcome>(o));
+    out << ",mean_turns\n";
+    for (size_t i = 0; i < points.size(); i++) {
+        const SweepPoint& point = points[i];
+        const SimulationReport& report = point.report;
+        for (size_t a = 0; a < axes.size(); a++) out << point.params.get(axes[a].param) << ",";
+        out << report.games << "," << point.winRate();
+        for (int o = OUTCOME_WIN + 1; o < OUTCOME_COUNT; o++) {
+            out << "," << (report.games ? static_cast<double>(report.outcomes[o]) / report.games : 0.0);
+        }
+        out << "," << (report.games ? static_cast<double>(report.turns) / report.games : 0.0) << "\n";
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "GameTypes.h"
+#include "BalanceParams.h"
+#include "MonteCarloRunner.h"
+#include <unordered_map>
+
+// One swept parameter: `steps` evenly spaced values from low to high
+struct SweepAxis {
+    BalanceParam param;
+    double low;
+    double high;
+    int steps;
+
+    SweepAxis(BalanceParam p = BALANCE_SOLDIER_PAY, double lo = 0.0, double hi = 0.0, int n = 1) :
+        param(p), low(lo), high(hi), steps(n < 1 ? 1 : n) {}
+
+    double value(int step) const {
+        return steps == 1 ? low : low + (high - low) * step / (steps - 1);
+    }
+
+    // Parses "name=low:high:steps", e.g. "soldier_pay=1:4:4"
+    static bool parse(const string& spec, SweepAxis& axis);
+};
+
+// A candidate parameter set and how its games went
+struct SweepPoint {
+    BalanceParams params;
+    SimulationReport report;
+
+    double winRate() const {
+        return report.games ? static_cast<double>(report.outcomes[OUTCOME_WIN]) / report.games : 0.0;
+    }
+};
+
+// Searches balance constants by simulation. Each candidate plays the same
+// games (the same seeds, hence the same events and the same random policy
+// decisions wherever the games agree), so differences between candidates
+// come from the parameters rather than from sampling noise. Each candidate's
+// games are spread over the runner's worker pool. Because the games are
+// fixed, a candidate equal to one already played (integer parameters are
+// rounded, so nearby grid steps and random draws often coincide) reuses
+// that report instead of replaying its games.
+class BalanceSweep {
+private:
+    MonteCarloRunner runner;
+    Difficulty difficulty;
+    uint64_t gamesPerCandidate;
+    uint64_t seed;
+    vector<SweepPoint> played;
+    unordered_multimap<uint64_t, size_t> playedIndex;   // params hash -> played
+    uint64_t lookups;
+    uint64_t reuses;
+
+public:
+    BalanceSweep(Difficulty diff, uint64_t games, uint64_t baseSeed, unsigned threads = 0) :
+        runner(threads), difficulty(diff), gamesPerCandidate(games), seed(baseSeed), lookups(0), reuses(0) {}
+
+    unsigned threadCount() const {
+        return runner.threadCount();
+    }
+
+    // Candidates evaluated so far, and how many of them reused a report
+    uint64_t candidatesEvaluated() const {
+        return lookups;
+    }
+
+    uint64_t candidatesReused() const {
+        return reuses;
+    }
+
+    SweepPoint evaluate(const BalanceParams& params);
+
+    // Every combination of the axes' values, the first axis varying slowest;
+    // parameters not on an axis keep their value in base
+    vector<SweepPoint> grid(const BalanceParams& base, const vector<SweepAxis>& axes);
+
+    // `count` candidates drawn uniformly from the axes' ranges
+    vector<SweepPoint> randomSearch(const BalanceParams& base, const vector<SweepAxis>& axes, size_t count);
+
+    // The point whose win rate is closest to target
+    static const SweepPoint* closest(const vector<SweepPoint>& points, double targetWinRate);
+
+    // One row per point: the swept values, games, win rate and the share of
+    // every other outcome. With two grid axes this is the win-rate surface.
+    static void writeCsv(ostream& out, const vector<SweepAxis>& axes, const vector<SweepPoint>& points);
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include "Narrator.h"
+#include "Inventory.h"
+#include "LoanLedger.h"
+
+struct KingdomRecord;
+class KingdomBatch;
+
+const float BASE_LOAN_RATE = 0.02f;   // interest per turn at full trust
+const float LOAN_RISK_PREMIUM = 0.08f; // added in proportion to lost trust
+const float MIN_LOAN_TRUST = 0.2f;    // no new loans below this trust
+
+class Bank {
+private:
+    int goldReserve;
+    float trustRate; // 1.0 = full trust, 0.0 = no trust
+    LoanLedger loans;
+    friend struct KingdomRecord;
+    friend class KingdomBatch;
+public:
+    Bank(int reserve = 10000) : goldReserve(reserve), trustRate(1.0f) {}
+
+    // Interest per turn a new loan would carry at the current trust
+    float loanRate() const {
+        return BASE_LOAN_RATE + (1.0f - trustRate) * LOAN_RISK_PREMIUM;
+    }
+
+    void giveLoan(int amount, int term, Inventory<int>& kingdomGold) {
+        if (amount <= 0) {
+            narrator() << " Invalid loan amount.\n";
+            return;
+        }
+        if (trustRate < MIN_LOAN_TRUST) {
+            narrator() << " Bank refuses the loan: the kingdom is not trusted.\n";
+            return;
+        }
+        if (amount > goldReserve) {
+            narrator() << " Bank cannot provide this loan: insufficient reserve.\n";
+            return;
+        }
+        if (term < 1) term = 1;
+        if (term > MAX_LOAN_TERM) term = MAX_LOAN_TERM;
+        float rate = loanRate();
+        int slot = loans.open(amount, rate, term);
+        if (slot < 0) {
+            narrator() << " Bank refuses the loan: too many loans outstanding.\n";
+            return;
+        }
+        goldReserve -= amount;
+        kingdomGold.add(amount);
+        narrator() << " Bank loaned " << amount << " gold at " << rate * 100 << "% per turn, repaid in "
+            << term << " installments of " << static_cast<int>(loans.payment[slot]) << " gold.\n";
+    }
+
+    // Returns false, and costs trust, if the kingdom cannot pay
+    bool receiveRepayment(int amount, Inventory<int>& kingdomGold) {
+        if (kingdomGold.get() < amount) {
+            narrator() << " Kingdom lacks enough gold to repay loan.\n";
+            trustRate -= 0.1f;
+            if (trustRate < 0.0f) trustRate = 0.0f;
+            return false;
+        }
+        kingdomGold.remove(amount);
+        goldReserve += amount;
+        trustRate += 0.05f;
+        if (trustRate > 1.0f) trustRate = 1.0f;
+        narrator() << " Loan installment of " << amount << " gold repaid. Trust rate increased.\n";
+        return true;
+    }
+
+    // Adds a turn of interest to every loan and collects the installments
+    // due. Unpaid installments stay on the balance. KingdomBatch::advanceEconomy
+    // must stay bit-for-bit identical to this.
+    void collectInstallments(Inventory<int>& kingdomGold) {
+        if (loans.activeCount() == 0) return;
+        int32_t amount;
+        LoanLedger::accrue(loans.balance, loans.rate, loans.payment, &amount, 1);
+        if (amount == 0) return;
+        bool paid = receiveRepayment(amount, kingdomGold);
+        LoanLedger::settle(loans.balance, loans.payment, loans.turnsLeft, paid);
+    }
+
+    const LoanLedger& getLoans() const {
+        return loans;
+    }
+
+    void audit() const {
+        narrator() << "\n Bank Audit Report:\n";
+        narrator() << "Gold Reserve: " << goldReserve << "\n";
+        narrator() << "Trust Rate: " << trustRate * 100 << "%\n";
+        for (int i = 0; i < MAX_LOANS; i++) {
+            if (loans.balance[i] == 0.0f) continue;
+            narrator() << "Loan " << i + 1 << ": " << loans.balance[i] << " gold owed at "
+                << loans.rate[i] * 100 << "% per turn, " << loans.turnsLeft[i] << " installments left\n";
+        }
+    }
+
+    float getTrustRate() const {
+        return trustRate;
+    }
+    int getReserve() const {
+        return goldReserve;
+    }
+
+};
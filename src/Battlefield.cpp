@@ -0,0 +1,325 @@
+#include "Battlefield.h"
+#include "Army.h"
+#include "Random.h"
+#include <cmath>
+
+static const int UNIT_HP = 5;
+static const int ARMED_ATTACK = 3;
+static const int UNARMED_ATTACK = 1;
+static const int HIT_CHANCE = 60;        // percent per swing
+static const int MORALE_PER_DAMAGE = 5;
+static const int ROUT_MORALE = 15;       // a unit flees below this
+static const int MORALE_SPREAD = 15;     // a soldier's morale is the army's plus or minus this
+static const int BREAK_PERCENT = 20;     // a side breaks below this share still fighting
+static const float REACH = 1.5f;
+static const float CELL_SIZE = 2.0f;     // at least REACH, so reach stays within 3x3 cells
+static const float SPEED = 1.0f;
+static const float FLEE_SPEED = 1.5f;
+static const float RANK_GAP = 6.0f;      // distance between the two front ranks
+static const float MARGIN = 8.0f;
+static const uint32_t CELL_CROWD = 6;        // a unit will not step into a cell holding this many allies
+static const uint32_t NO_CELL = 0xFFFFFFFFu;
+
+Battlefield::Battlefield(unsigned threads) : pool(threads) {
+    reset(1);
+}
+
+void Battlefield::reset(uint64_t battleSeed) {
+    x.clear();
+    y.clear();
+    hp.clear();
+    morale.clear();
+    attack.clear();
+    side.clear();
+    state.clear();
+    seed = battleSeed;
+    stepCount = 0;
+    started = false;
+    decided = false;
+    result = BattleResult();
+    result.winner = -1;
+}
+
+void Battlefield::deploy(int sideIndex, int soldiers, int weapons, int armyMorale) {
+    // Wide, shallow formation, one pace between soldiers: about four times
+    // as many files as ranks. Side 0 faces north from below y = 0.
+    int files = max(1, static_cast<int>(ceil(sqrt(soldiers * 4.0))));
+    float facing = sideIndex == 0 ? -1.0f : 1.0f;
+    for (int i = 0; i < soldiers; i++) {
+        int rank = i / files;
+        int file = i % files;
+        x.push_back(file - files * 0.5f);
+        y.push_back(facing * (RANK_GAP * 0.5f + rank));
+        hp.push_back(UNIT_HP);
+        // Soldiers' nerve varies around the army's morale, so a rout spreads
+        // through a side rather than taking it all on one step
+        uint64_t nerve = Random::at(seed, 0, 1 + sideIndex, static_cast<uint32_t>(i));
+        morale.push_back(armyMorale + Random::bounded(nerve, 2 * MORALE_SPREAD + 1) - MORALE_SPREAD);
+        attack.push_back(i < weapons ? ARMED_ATTACK : UNARMED_ATTACK);
+        side.push_back(static_cast<uint8_t>(sideIndex));
+        state.push_back(UNIT_FIGHTING);
+    }
+    result.deployed[sideIndex] += soldiers;
+}
+
+// The field is fixed when the battle starts: the bounding box of both
+// deployments plus a margin. Routed units leaving it have escaped.
+void Battlefield::layoutGrid() {
+    float minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        minX = min(minX, x[i]);
+        maxX = max(maxX, x[i]);
+        minY = min(minY, y[i]);
+        maxY = max(maxY, y[i]);
+    }
+    originX = minX - MARGIN;
+    originY = minY - MARGIN;
+    fieldWidth = maxX - minX + 2 * MARGIN;
+    fieldHeight = maxY - minY + 2 * MARGIN;
+    gridWidth = static_cast<int>(fieldWidth / CELL_SIZE) + 1;
+    gridHeight = static_cast<int>(fieldHeight / CELL_SIZE) + 1;
+    size_t cells = static_cast<size_t>(gridWidth) * gridHeight;
+    cellStart.assign(2 * cells + 1, 0);
+    cellUnits.resize(x.size());
+    unitCell.resize(x.size());
+    nextX.resize(x.size());
+    nextY.resize(x.size());
+    target.assign(x.size(), -1);
+    started = true;
+}
+
+int Battlefield::cellOf(float px, float py) const {
+    int cx = static_cast<int>((px - originX) / CELL_SIZE);
+    int cy = static_cast<int>((py - originY) / CELL_SIZE);
+    if (cx < 0 || cy < 0 || cx >= gridWidth || cy >= gridHeight) return -1;
+    return cy * gridWidth + cx;
+}
+
+// Counting sort of the units still on the field into their cells, one run
+// of cells per side, so a side's units in a row of cells are contiguous
+void Battlefield::buildGrid() {
+    size_t buckets = cellStart.size() - 1;
+    size_t cells = buckets / 2;
+    fill(cellStart.begin(), cellStart.end(), 0);
+    float sumX[2] = { 0, 0 }, sumY[2] = { 0, 0 };
+    int count[2] = { 0, 0 };
+    for (size_t i = 0; i < x.size(); i++) {
+        unitCell[i] = NO_CELL;
+        if (state[i] == UNIT_DEAD || state[i] == UNIT_ESCAPED) continue;
+        int c = cellOf(x[i], y[i]);
+        if (c < 0) continue;
+        unitCell[i] = static_cast<uint32_t>(c);
+        cellStart[side[i] * cells + c + 1]++;
+        if (state[i] == UNIT_FIGHTING) {
+            sumX[side[i]] += x[i];
+            sumY[side[i]] += y[i];
+            count[side[i]]++;
+        }
+    }
+    for (size_t b = 0; b < buckets; b++) cellStart[b + 1] += cellStart[b];
+    // cellStart[b] doubles as the insert cursor, then is shifted back
+    for (size_t i = 0; i < x.size(); i++) {
+        if (unitCell[i] == NO_CELL) continue;
+        cellUnits[cellStart[side[i] * cells + unitCell[i]]++] = static_cast<uint32_t>(i);
+    }
+    for (size_t b = buckets; b > 0; b--) cellStart[b] = cellStart[b - 1];
+    cellStart[0] = 0;
+
+    for (int s = 0; s < 2; s++) {
+        fighting[s] = count[s];
+        centroidX[s] = count[s] ? sumX[s] / count[s] : 0.0f;
+        centroidY[s] = count[s] ? sumY[s] / count[s] : 0.0f;
+        int lost = result.deployed[s] - count[s];
+        lossPercent[s] = result.deployed[s] ? lost * 100 / result.deployed[s] : 0;
+    }
+}
+
+int Battlefield::nearestEnemy(size_t i, int cx, int cy, int radius, float& best) const {
+    size_t enemyCells = (1 - side[i]) * (cellStart.size() / 2);
+    int left = max(cx - radius, 0);
+    int right = min(cx + radius, gridWidth - 1);
+    float ux = x[i], uy = y[i];
+    int nearest = -1;
+    best = 1e30f;
+    // The enemies in one row of cells are a single run of cellUnits
+    for (int ny = max(cy - radius, 0); ny <= min(cy + radius, gridHeight - 1); ny++) {
+        size_t row = enemyCells + static_cast<size_t>(ny) * gridWidth;
+        for (uint32_t k = cellStart[row + left]; k < cellStart[row + right + 1]; k++) {
+            uint32_t j = cellUnits[k];
+            float dx = x[j] - ux;
+            float dy = y[j] - uy;
+            float d2 = dx * dx + dy * dy;
+            if (d2 < best) {
+                best = d2;
+                nearest = static_cast<int>(j);
+            }
+        }
+    }
+    return nearest;
+}
+
+void Battlefield::aim(size_t i) {
+    nextX[i] = x[i];
+    nextY[i] = y[i];
+    target[i] = -1;
+    if (unitCell[i] == NO_CELL) return;
+
+    if (state[i] == UNIT_ROUTED) {
+        nextY[i] = y[i] + (side[i] == 0 ? -FLEE_SPEED : FLEE_SPEED);
+        return;
+    }
+
+    // Nearest enemy in the 3x3 cells around the unit, which cover its reach;
+    // if none is in reach, widen to 5x5 to pick a direction to march
+    int enemy = 1 - side[i];
+    int cx = static_cast<int>(unitCell[i] % gridWidth);
+    int cy = static_cast<int>(unitCell[i] / gridWidth);
+    float best = 1e30f;
+    int nearest = nearestEnemy(i, cx, cy, 1, best);
+    if (nearest >= 0 && best <= REACH * REACH) {
+        target[i] = nearest;
+        return;
+    }
+    nearest = nearestEnemy(i, cx, cy, 2, best);
+
+    float tx = nearest >= 0 ? x[nearest] : centroidX[enemy];
+    float ty = nearest >= 0 ? y[nearest] : centroidY[enemy];
+    float dx = tx - x[i];
+    float dy = ty - y[i];
+    float distance = sqrt(dx * dx + dy * dy);
+    if (distance > 0.0f) {
+        float stepLength = min(SPEED, distance);
+        float px = x[i] + dx / distance * stepLength;
+        float py = y[i] + dy / distance * stepLength;
+        // Ranks queue behind the fighting instead of piling into it
+        int c = cellOf(px, py);
+        if (c >= 0 && (static_cast<uint32_t>(c) == unitCell[i] || bucketSize(c, side[i]) < CELL_CROWD)) {
+            nextX[i] = px;
+            nextY[i] = py;
+        }
+    }
+}
+
+void Battlefield::resolve(size_t j) {
+    if (unitCell[j] == NO_CELL) return;
+
+    // Hits from every enemy in reach that aimed at this unit
+    size_t enemyCells = (1 - side[j]) * (cellStart.size() / 2);
+    int cx = static_cast<int>(unitCell[j] % gridWidth);
+    int cy = static_cast<int>(unitCell[j] / gridWidth);
+    int left = max(cx - 1, 0);
+    int right = min(cx + 1, gridWidth - 1);
+    int damage = 0;
+    for (int ny = max(cy - 1, 0); ny <= min(cy + 1, gridHeight - 1); ny++) {
+        size_t row = enemyCells + static_cast<size_t>(ny) * gridWidth;
+        for (uint32_t k = cellStart[row + left]; k < cellStart[row + right + 1]; k++) {
+            uint32_t i = cellUnits[k];
+            if (target[i] != static_cast<int32_t>(j)) continue;
+            uint64_t roll = Random::at(seed, static_cast<uint32_t>(stepCount), 0, i);
+            if (Random::bounded(roll, 100) < HIT_CHANCE) damage += attack[i];
+        }
+    }
+
+    if (damage > 0) {
+        hp[j] -= damage;
+        morale[j] -= damage * MORALE_PER_DAMAGE;
+        if (hp[j] <= 0) {
+            state[j] = UNIT_DEAD;
+            return;
+        }
+    }
+    if (state[j] == UNIT_FIGHTING && morale[j] - lossPercent[side[j]] < ROUT_MORALE) {
+        state[j] = UNIT_ROUTED;
+    }
+    if (state[j] == UNIT_ROUTED && cellOf(nextX[j], nextY[j]) < 0) {
+        state[j] = UNIT_ESCAPED;
+    }
+}
+
+bool Battlefield::step() {
+    if (!started) layoutGrid();
+    if (decided) return false;
+
+    buildGrid();
+    bool broken[2];
+    for (int s = 0; s < 2; s++) {
+        broken[s] = fighting[s] == 0 || fighting[s] * 100 < result.deployed[s] * BREAK_PERCENT;
+    }
+    if (broken[0] || broken[1]) {
+        // If both break on the same step, the side keeping the larger share
+        // of its army in the fight holds the field
+        decided = true;
+        if (broken[0] != broken[1]) {
+            result.winner = broken[0] ? 1 : 0;
+        }
+        else {
+            int64_t held0 = static_cast<int64_t>(fighting[0]) * result.deployed[1];
+            int64_t held1 = static_cast<int64_t>(fighting[1]) * result.deployed[0];
+            result.winner = held0 == held1 ? -1 : (held0 > held1 ? 0 : 1);
+        }
+        return false;
+    }
+
+    size_t count = x.size();
+    pool.parallelFor(count, 1024, [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) aim(i);
+    });
+    pool.parallelFor(count, 1024, [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) resolve(i);
+    });
+    x.swap(nextX);
+    y.swap(nextY);
+    stepCount++;
+    return true;
+}
+
+const BattleResult& Battlefield::run(int maxSteps) {
+    while (stepCount < maxSteps && step()) {
+    }
+    for (int s = 0; s < 2; s++) {
+        result.killed[s] = 0;
+        result.routed[s] = 0;
+        result.standing[s] = 0;
+    }
+    for (size_t i = 0; i < state.size(); i++) {
+        switch (state[i]) {
+        case UNIT_DEAD: result.killed[side[i]]++; break;
+        case UNIT_FIGHTING: result.standing[side[i]]++; break;
+        default: result.routed[side[i]]++; break;
+        }
+    }
+    result.steps = stepCount;
+    return result;
+}
+
+BattleResult fightBattle(Battlefield& field, Army& attacker, int attackerWeapons,
+    Army& defender, int defenderWeapons, uint64_t seed) {
+    field.reset(seed);
+    field.deploy(0, attacker.getSoldiers(), attackerWeapons, attacker.getMorale());
+    field.deploy(1, defender.getSoldiers(), defenderWeapons, defender.getMorale());
+    BattleResult result = field.run();
+    attacker.endBattle(result, 0);
+    defender.endBattle(result, 1);
+    return result;
+}
+
+BattleResult Army::battle(Battlefield& field, const Inventory<int>& armory, Army& enemy, int enemyWeapons,
+    uint64_t seed) {
+    if (soldiers == 0) {
+        narrator() << "No soldiers to fight\n";
+        return BattleResult();
+    }
+    int armed = armory.get() > 0 ? armory.get() : 0;
+    BattleResult result = fightBattle(field, *this, armed, enemy, enemyWeapons, seed);
+    const char* verdict = result.winner == 0 ? "won" : (result.winner < 0 ? "drawn" : "lost");
+    narrator() << "Battle " << verdict << "! Lost " << result.killed[0] << " soldiers. Morale " << morale << "%\n";
+    return result;
+}
+
+void Army::endBattle(const BattleResult& result, int side) {
+    inWar = true;
+    addSoldiers(-result.killed[side]);
+    int change = result.winner == side ? 10 : (result.winner < 0 ? -5 : -20);
+    int newMorale = morale + change;
+    morale = newMorale < 0 ? 0 : (newMorale > 100 ? 100 : newMorale);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "GameTypes.h"
+#include "WorkStealingPool.h"
+
+class Army;
+
+struct BattleResult {
+    BattleResult() : steps(0), winner(-1) {
+        for (int s = 0; s < 2; s++) deployed[s] = killed[s] = routed[s] = standing[s] = 0;
+    }
+
+    int steps;
+    int winner;            // 0 or 1, -1 for a draw or if no side broke
+    int deployed[2];
+    int killed[2];
+    int routed[2];         // fled the field alive
+    int standing[2];       // still fighting at the end
+};
+
+// Tactical battle between two armies of individual soldiers. Units live in
+// structure-of-arrays form and are bucketed into a uniform grid every step,
+// so finding enemies in reach only looks at the 3x3 cells around a unit.
+// A step runs in two parallel passes over the units:
+//   aim    - each unit picks its target and works out its next position;
+//   resolve- each unit sums the hits aimed at it by enemies in the nearby
+//            cells, then takes the damage, loses morale, dies or routs.
+// Each pass writes only the unit's own slots, and hit rolls are counter-based
+// draws keyed by (seed, step, unit), so a battle gives the same result on any
+// number of threads.
+class Battlefield {
+private:
+    enum UnitState : uint8_t { UNIT_FIGHTING, UNIT_ROUTED, UNIT_DEAD, UNIT_ESCAPED };
+
+    // Unit arrays
+    vector<float> x, y;
+    vector<float> nextX, nextY;
+    vector<int32_t> hp;
+    vector<int32_t> morale;
+    vector<int32_t> attack;
+    vector<int32_t> target;
+    vector<uint8_t> side;
+    vector<uint8_t> state;
+
+    // Spatial hash: units sorted by side, then cell. With n cells, the units
+    // of side s in cell c are cellUnits[cellStart[s*n + c]..cellStart[s*n + c + 1])
+    int gridWidth;
+    int gridHeight;
+    float originX;
+    float originY;
+    vector<uint32_t> cellStart;
+    vector<uint32_t> cellUnits;
+    vector<uint32_t> unitCell;
+
+    float fieldWidth;
+    float fieldHeight;
+    bool started;
+    bool decided;
+    float centroidX[2], centroidY[2];
+    int lossPercent[2];
+    int fighting[2];
+    int stepCount;
+    uint64_t seed;
+    BattleResult result;
+    WorkStealingPool pool;
+
+    int cellOf(float px, float py) const;
+    uint32_t bucketSize(int c, int s) const {
+        size_t b = s * (cellStart.size() / 2) + c;
+        return cellStart[b + 1] - cellStart[b];
+    }
+    void layoutGrid();
+    void buildGrid();
+    int nearestEnemy(size_t i, int cx, int cy, int radius, float& best) const;
+    void aim(size_t i);
+    void resolve(size_t i);
+
+public:
+    explicit Battlefield(unsigned threads = 0);
+
+    // Clears the field for a new battle between two deployments
+    void reset(uint64_t battleSeed);
+
+    // Lines up `soldiers` units for side 0 (south) or 1 (north). The first
+    // `weapons` of them are armed; each soldier's morale varies around the
+    // army's 0-100 morale.
+    void deploy(int sideIndex, int soldiers, int weapons, int armyMorale);
+
+    // Advances one step; returns false once the battle is decided
+    bool step();
+
+    // Steps until one side breaks or maxSteps pass
+    const BattleResult& run(int maxSteps = 2000);
+
+    const BattleResult& getResult() const {
+        return result;
+    }
+
+    unsigned threadCount() const {
+        return pool.size();
+    }
+};
+
+// Fights a tactical battle between two armies and applies the losses: the
+// killed leave each army, routed soldiers straggle back, the winner gains
+// morale and the loser loses it
+BattleResult fightBattle(Battlefield& field, Army& attacker, int attackerWeapons,
+    Army& defender, int defenderWeapons, uint64_t seed);
@@ -0,0 +1,62 @@
+#pragma once
+#include "Narrator.h"
+#include "Inventory.h"
+#include "BalanceParams.h"
+
+struct KingdomRecord;
+
+class BuildingSystem {
+private:
+    int farms;
+    int barracks;
+    int mines;
+    int blacksmiths;
+    uint64_t zobrist;   // keys of the four building counts
+    friend struct KingdomRecord;
+
+    void rehash() {
+        zobrist = zobristKey(HASH_FARMS, farms) ^ zobristKey(HASH_BARRACKS, barracks)
+            ^ zobristKey(HASH_MINES, mines) ^ zobristKey(HASH_BLACKSMITHS, blacksmiths);
+    }
+public:
+    BuildingSystem() : farms(1), barracks(1), mines(1), blacksmiths(1) {
+        rehash();
+    }
+
+    int getFarms() const { return farms; }
+    int getBarracks() const { return barracks; }
+    int getMines() const { return mines; }
+
+    void buildFarm(Inventory<int>& wood, Inventory<int>& stone, const BalanceParams& balance) {
+        if (wood.get() < balance.farmWoodCost || stone.get() < balance.farmStoneCost) {
+            narrator() << "Not enough resources\n";
+            return;
+        }
+        wood.remove(balance.farmWoodCost);
+        stone.remove(balance.farmStoneCost);
+        farms++;
+        zobrist ^= zobristKey(HASH_FARMS, farms - 1) ^ zobristKey(HASH_FARMS, farms);
+        narrator() << "Built a new farm. Total farms: " << farms << "\n";
+    }
+
+    void buildBarracks(Inventory<int>& wood, Inventory<int>& stone, const BalanceParams& balance) {
+        if (wood.get() < balance.barracksWoodCost || stone.get() < balance.barracksStoneCost) {
+            narrator() << "Not enough resources\n";
+            return;
+        }
+        wood.remove(balance.barracksWoodCost);
+        stone.remove(balance.barracksStoneCost);
+        barracks++;
+        zobrist ^= zobristKey(HASH_BARRACKS, barracks - 1) ^ zobristKey(HASH_BARRACKS, barracks);
+        narrator() << "Built a new barracks. Total barracks: " << barracks << "\n";
+    }
+
+    uint64_t hash() const {
+        return zobrist;
+    }
+
+    void produceResources(Inventory<int>& food, Inventory<int>& iron, const BalanceParams& balance) {
+        food.add(farms * balance.farmYield);
+        iron.add(mines * balance.mineYield);
+    }
+};
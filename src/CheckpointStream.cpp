@@ -0,0 +1,259 @@
+#include "CheckpointStream.h"
+#include "Kingdom.h"
+#include "Zobrist.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <iterator>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHECKPOINT_SIMD 1
+#endif
+
+static const char CHECKPOINT_MAGIC[8] = { 'S', 'H', 'C', 'K', 'P', 'T', '1', 0 };
+
+static const size_t RECORD_WORDS = sizeof(KingdomRecord) / sizeof(uint32_t);
+static_assert(sizeof(KingdomRecord) % 16 == 0, "records are compared in groups of four words");
+
+// A gap and a residual of at most 5 bytes each per word
+static const size_t MAX_PAYLOAD = RECORD_WORDS * 10;
+
+enum FrameKind { FRAME_KEYFRAME, FRAME_DELTA };
+
+// Which words of a record hold floats, so get XOR residuals
+struct FloatWords {
+    bool isFloat[RECORD_WORDS];
+
+    void mark(size_t offset, size_t size) {
+        for (size_t i = offset / 4; i < (offset + size) / 4; i++) isFloat[i] = true;
+    }
+
+    FloatWords() {
+        for (size_t i = 0; i < RECORD_WORDS; i++) isFloat[i] = false;
+        mark(offsetof(KingdomRecord, cohorts), sizeof(KingdomRecord::cohorts));
+        mark(offsetof(KingdomRecord, bankTrust), sizeof(KingdomRecord::bankTrust));
+        mark(offsetof(KingdomRecord, loanBalance), sizeof(KingdomRecord::loanBalance));
+        mark(offsetof(KingdomRecord, loanRate), sizeof(KingdomRecord::loanRate));
+        mark(offsetof(KingdomRecord, loanPayment), sizeof(KingdomRecord::loanPayment));
+    }
+};
+
+static const FloatWords& floatWords() {
+    static const FloatWords words;
+    return words;
+}
+
+// Steps a record to the next turn as if nothing but time happened
+static void predict(KingdomRecord& record) {
+    float cohorts[RECORD_COHORT_COUNT];
+    Population::project(record.cohorts, cohorts);
+    memcpy(record.cohorts, cohorts, sizeof(cohorts));
+    record.turn++;
+    record.rngTurn++;
+}
+
+static uint64_t predictorFingerprint() {
+    KingdomRecord record;
+    memset(&record, 0, sizeof(record));
+    for (int i = 0; i < RECORD_COHORT_COUNT; i++) record.cohorts[i] = 1000.0f / (i + 3);
+    for (int t = 0; t < 8; t++) predict(record);
+    uint64_t fingerprint = 0;
+    for (int i = 0; i < RECORD_COHORT_COUNT; i++) {
+        uint32_t bits;
+        memcpy(&bits, &record.cohorts[i], sizeof(bits));
+        fingerprint ^= zobristKey(i, bits);
+    }
+    return fingerprint;
+}
+
+// Appends the words of `record` that differ from `base`. Most words match,
+// so they are compared four at a time first.
+static uint8_t* encodeWords(const KingdomRecord& base, const KingdomRecord& record, uint8_t* out) {
+    const char* from = reinterpret_cast<const char*>(&base);
+    const char* to = reinterpret_cast<const char*>(&record);
+    const bool* isFloat = floatWords().isFloat;
+    size_t next = 0;
+    for (size_t group = 0; group < RECORD_WORDS / 4; group++) {
+#ifdef CHECKPOINT_SIMD
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from) + group);
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(to) + group);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)) == 0xFFFF) continue;
+#endif
+        for (size_t i = group * 4; i < group * 4 + 4; i++) {
+            uint32_t x, y;
+            memcpy(&x, from + i * 4, 4);
+            memcpy(&y, to + i * 4, 4);
+            if (x == y) continue;
+            uint32_t residual = isFloat[i] ? x ^ y : zigzag(static_cast<int32_t>(y - x));
+            out = putVarint(out, static_cast<uint32_t>(i - next));
+            out = putVarint(out, residual);
+            next = i + 1;
+        }
+    }
+    return out;
+}
+
+// Applies a payload from encodeWords to `record`, which holds the base
+static bool decodeWords(const char* p, const char* end, KingdomRecord& record) {
+    uint32_t words[RECORD_WORDS];
+    memcpy(words, &record, sizeof(words));
+    const bool* isFloat = floatWords().isFloat;
+    uint64_t next = 0;
+    while (p < end) {
+        uint64_t gap, residual;
+        if (!getVarint(p, end, gap) || !getVarint(p, end, residual)) return false;
+        uint64_t i = next + gap;
+        if (i >= RECORD_WORDS) return false;
+        if (isFloat[i]) words[i] ^= static_cast<uint32_t>(residual);
+        else words[i] += static_cast<uint32_t>(unzigzag(residual));
+        next = i + 1;
+    }
+    memcpy(&record, words, sizeof(words));
+    return true;
+}
+
+CheckpointHeader CheckpointHeader::make(uint32_t interval) {
+    CheckpointHeader header;
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = KINGDOM_RECORD_VERSION;
+    header.recordSize = sizeof(KingdomRecord);
+    header.keyframeInterval = interval;
+    header.reserved = 0;
+    header.predictor = predictorFingerprint();
+    return header;
+}
+
+CheckpointEncoder::CheckpointEncoder(uint32_t keyframeInterval) :
+    interval(keyframeInterval < 1 ? 1 : keyframeInterval), sinceKeyframe(0) {}
+
+void CheckpointEncoder::encode(uint32_t game, const KingdomRecord& record, CheckpointChunk& chunk) {
+    uint8_t payload[MAX_PAYLOAD];
+    bool keyframe = sinceKeyframe == 0;
+    // previous is replaced by record below, so it can hold the base meanwhile
+    if (keyframe) memset(&previous, 0, sizeof(previous));
+    else predict(previous);
+    uint8_t* end = encodeWords(previous, record, payload);
+    previous = record;
+    if (++sinceKeyframe == interval) sinceKeyframe = 0;
+
+    uint8_t header[16];
+    uint8_t* h = header;
+    *h++ = static_cast<uint8_t>(keyframe ? FRAME_KEYFRAME : FRAME_DELTA);
+    h = putVarint(h, game);
+    h = putVarint(h, zigzag(record.turn));
+    h = putVarint(h, static_cast<uint32_t>(end - payload));
+    chunk.bytes.append(reinterpret_cast<const char*>(header), h - header);
+    chunk.bytes.append(reinterpret_cast<const char*>(payload), end - payload);
+    chunk.frames++;
+    if (keyframe) chunk.keyframes++;
+}
+
+void CheckpointEncoder::encode(uint32_t game, const Kingdom& kingdom, CheckpointChunk& chunk) {
+    encode(game, KingdomRecord::capture(kingdom), chunk);
+}
+
+CheckpointWriter::CheckpointWriter(size_t chunkLimit) :
+    ChunkWriter(chunkLimit), interval(CHECKPOINT_DEFAULT_INTERVAL), frames(0), keyframes(0), bytes(0) {}
+
+CheckpointWriter::~CheckpointWriter() {
+    close();
+}
+
+bool CheckpointWriter::open(const string& path, uint32_t keyframeInterval) {
+    if (!create(path)) return false;
+    interval = keyframeInterval < 1 ? 1 : keyframeInterval;
+    CheckpointHeader header = CheckpointHeader::make(interval);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    frames.store(0, memory_order_relaxed);
+    keyframes.store(0, memory_order_relaxed);
+    bytes.store(sizeof(header), memory_order_relaxed);
+    start();
+    return true;
+}
+
+void CheckpointWriter::write(const CheckpointChunk& chunk) {
+    file.write(chunk.bytes.data(), chunk.bytes.size());
+    frames.fetch_add(chunk.frames, memory_order_relaxed);
+    keyframes.fetch_add(chunk.keyframes, memory_order_relaxed);
+    bytes.fetch_add(chunk.bytes.size(), memory_order_relaxed);
+}
+
+bool CheckpointReader::open(const string& path) {
+    games.clear();
+    frameCount = 0;
+    ifstream file(path, ios::binary);
+    if (!file) return false;
+    data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+    CheckpointHeader header;
+    CheckpointHeader expected = CheckpointHeader::make(0);
+    if (data.size() < sizeof(header)) return false;
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != expected.version || header.recordSize != expected.recordSize ||
+        header.predictor != expected.predictor) {
+        return false;
+    }
+
+    const char* begin = data.data();
+    const char* p = begin + sizeof(header);
+    const char* end = begin + data.size();
+    while (p < end) {
+        uint8_t kind = static_cast<uint8_t>(*p++);
+        uint64_t game, turn, length;
+        if (kind > FRAME_DELTA || !getVarint(p, end, game) || !getVarint(p, end, turn) ||
+            !getVarint(p, end, length) || length > static_cast<uint64_t>(end - p)) {
+            break;
+        }
+        vector<Frame>& index = games[static_cast<uint32_t>(game)];
+        // A delta with no keyframe before it cannot be decoded
+        if (kind == FRAME_DELTA && index.empty()) {
+            p += length;
+            continue;
+        }
+        Frame frame;
+        frame.turn = unzigzag(turn);
+        frame.keyframe = kind == FRAME_KEYFRAME ? static_cast<uint32_t>(index.size()) : index.back().keyframe;
+        frame.offset = p - begin;
+        frame.length = static_cast<size_t>(length);
+        index.push_back(frame);
+        frameCount++;
+        p += length;
+    }
+    return true;
+}
+
+vector<int> CheckpointReader::turns(uint32_t game) const {
+    vector<int> result;
+    auto found = games.find(game);
+    if (found == games.end()) return result;
+    for (size_t i = 0; i < found->second.size(); i++) result.push_back(found->second[i].turn);
+    return result;
+}
+
+bool CheckpointReader::restore(uint32_t game, int turn, KingdomRecord& record) const {
+    auto found = games.find(game);
+    if (found == games.end()) return false;
+    const vector<Frame>& index = found->second;
+    auto at = lower_bound(index.begin(), index.end(), turn,
+        [](const Frame& frame, int t) { return frame.turn < t; });
+    if (at == index.end() || at->turn != turn) return false;
+
+    size_t target = at - index.begin();
+    KingdomRecord state;
+    memset(&state, 0, sizeof(state));
+    for (size_t i = at->keyframe; i <= target; i++) {
+        if (i > at->keyframe) predict(state);
+        const char* payload = data.data() + index[i].offset;
+        if (!decodeWords(payload, payload + index[i].length, state)) return false;
+    }
+    if (!state.isValid()) return false;
+    record = state;
+    return true;
+}
+
+bool CheckpointReader::restore(uint32_t game, int turn, Kingdom& kingdom) const {
+    KingdomRecord record;
+    return restore(game, turn, record) && record.restore(kingdom);
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include "GameTypes.h"
+#include "KingdomRecord.h"
+#include "ChunkWriter.h"
+#include <atomic>
+#include <unordered_map>
+
+class Kingdom;
+
+const uint32_t CHECKPOINT_DEFAULT_INTERVAL = 32;
+const size_t CHECKPOINT_CHUNK_BYTES = 256 * 1024;
+
+// Header at the start of a checkpoint file. `predictor` fingerprints the
+// cohort projection deltas are taken against; a build that projects
+// differently (e.g. one that fuses multiply-adds) cannot decode the file.
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t keyframeInterval;
+    uint32_t reserved;
+    uint64_t predictor;
+
+    static CheckpointHeader make(uint32_t interval);
+};
+
+// Encoded frames waiting to be written. A producer fills one and hands it
+// to CheckpointWriter::submit once full().
+struct CheckpointChunk {
+    string bytes;
+    uint64_t frames;
+    uint64_t keyframes;
+
+    CheckpointChunk() : frames(0), keyframes(0) {
+        bytes.reserve(CHECKPOINT_CHUNK_BYTES + sizeof(KingdomRecord) * 2);
+    }
+
+    bool full() const {
+        return bytes.size() >= CHECKPOINT_CHUNK_BYTES;
+    }
+
+    bool empty() const {
+        return frames == 0;
+    }
+
+    void clear() {
+        bytes.clear();
+        frames = 0;
+        keyframes = 0;
+    }
+};
+
+// Encodes the checkpoints of one game. Every keyframeInterval-th checkpoint
+// (and the first) is a keyframe that stands alone; the rest are deltas from
+// the checkpoint before. A delta is taken against a prediction of the next
+// turn, the previous record with the turn counters stepped and the cohorts
+// projected one turn of demography ahead, so an undisturbed population costs
+// nothing. Each 32-bit word of the record that differs from the prediction
+// is stored as a varint gap from the last one stored and a varint residual:
+// the XOR for floats, whose high bits rarely move, and the zigzagged
+// difference for integers. A keyframe is the same encoding against an
+// all-zero record.
+class CheckpointEncoder {
+private:
+    KingdomRecord previous;
+    uint32_t interval;
+    uint32_t sinceKeyframe;
+
+public:
+    explicit CheckpointEncoder(uint32_t keyframeInterval = CHECKPOINT_DEFAULT_INTERVAL);
+
+    // Appends the frame for the state of game `game` to chunk
+    void encode(uint32_t game, const KingdomRecord& record, CheckpointChunk& chunk);
+    void encode(uint32_t game, const Kingdom& kingdom, CheckpointChunk& chunk);
+};
+
+// Writes checkpoint chunks to a file on a background thread. Producers
+// encode in parallel, each game with its own CheckpointEncoder, so the
+// writer thread only copies bytes out. Frames of different games may
+// interleave; those of one game must be submitted in order.
+//
+// Frame layout: a kind byte (0 keyframe, 1 delta), then varints for the
+// game, the turn and the payload length, then the payload.
+//
+// Chunks are queued and recycled by ChunkWriter, as for TelemetryWriter.
+class CheckpointWriter : public ChunkWriter<CheckpointChunk> {
+private:
+    uint32_t interval;
+    atomic<uint64_t> frames;   // updated by the writer thread
+    atomic<uint64_t> keyframes;
+    atomic<uint64_t> bytes;
+
+protected:
+    void write(const CheckpointChunk& chunk) override;
+
+public:
+    explicit CheckpointWriter(size_t chunkLimit = 16);
+    ~CheckpointWriter();
+
+    // Creates the file, writes the header and starts the writer thread
+    bool open(const string& path, uint32_t keyframeInterval = CHECKPOINT_DEFAULT_INTERVAL);
+
+    // For the producers' encoders
+    uint32_t keyframeInterval() const {
+        return interval;
+    }
+
+    // Totals so far; safe to read while writing, exact once close() has
+    // returned
+    uint64_t framesWritten() const {
+        return frames.load(memory_order_relaxed);
+    }
+
+    uint64_t keyframesWritten() const {
+        return keyframes.load(memory_order_relaxed);
+    }
+
+    uint64_t bytesWritten() const {
+        return bytes.load(memory_order_relaxed);
+    }
+};
+
+// Random access to a checkpoint file. open() reads the file and indexes
+// every frame by game and turn; restoring a turn decodes forward from the
+// keyframe before it, so it costs at most keyframeInterval frames. A
+// truncated last frame (e.g. after a crash) is dropped.
+class CheckpointReader {
+private:
+    struct Frame {
+        int32_t turn;
+        uint32_t keyframe;   // index of this game's keyframe the frame builds on
+        size_t offset;       // of the payload
+        size_t length;
+    };
+
+    vector<char> data;
+    unordered_map<uint32_t, vector<Frame>> games;
+    uint64_t frameCount;
+
+public:
+    CheckpointReader() : frameCount(0) {}
+
+    bool open(const string& path);
+
+    size_t gameCount() const {
+        return games.size();
+    }
+
+    uint64_t checkpointCount() const {
+        return frameCount;
+    }
+
+    // The turns game `game` has checkpoints for, in order
+    vector<int> turns(uint32_t game) const;
+
+    // The state of game `game` at `turn`; false if it has no checkpoint there
+    bool restore(uint32_t game, int turn, KingdomRecord& record) const;
+    bool restore(uint32_t game, int turn, Kingdom& kingdom) const;
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include "GameTypes.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Writes chunks that producer threads fill to a file on a background
+// thread. Chunks come from a fixed set that is recycled once written;
+// acquire() blocks while all of them are queued, which keeps memory bounded
+// if the disk falls behind. A Chunk has empty() and clear(); the subclass
+// writes its header in open() and encodes each chunk in write().
+//
+// Subclass destructors must call close(), since the writer thread calls
+// write() until it stops.
+template <typename Chunk>
+class ChunkWriter {
+private:
+    thread writer;
+    mutex lock;
+    condition_variable queued;     // the writer waits for chunks
+    condition_variable recycled;   // producers wait for a free chunk
+    deque<Chunk*> pending;
+    vector<Chunk*> spare;
+    vector<unique_ptr<Chunk>> chunks;
+    size_t maxChunks;
+    bool stopping;
+
+    void recycle(Chunk* chunk) {
+        chunk->clear();
+        spare.push_back(chunk);
+        recycled.notify_one();
+    }
+
+    void writerLoop() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            queued.wait(guard, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) return;
+            Chunk* chunk = pending.front();
+            pending.pop_front();
+            guard.unlock();
+
+            write(*chunk);
+
+            guard.lock();
+            recycle(chunk);
+        }
+    }
+
+protected:
+    ofstream file;
+
+    // Creates the file; the subclass then writes its header and calls start()
+    bool create(const string& path) {
+        close();
+        file.open(path, ios::binary | ios::trunc);
+        return static_cast<bool>(file);
+    }
+
+    void start() {
+        stopping = false;
+        writer = thread(&ChunkWriter::writerLoop, this);
+    }
+
+    // Writes one queued chunk to file; runs on the writer thread
+    virtual void write(const Chunk& chunk) = 0;
+
+public:
+    explicit ChunkWriter(size_t chunkLimit) : maxChunks(chunkLimit < 2 ? 2 : chunkLimit), stopping(false) {}
+    virtual ~ChunkWriter() {}
+
+    ChunkWriter(const ChunkWriter&) = delete;
+    ChunkWriter& operator=(const ChunkWriter&) = delete;
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    // An empty chunk to fill; safe to call from any thread
+    Chunk* acquire() {
+        unique_lock<mutex> guard(lock);
+        if (spare.empty() && chunks.size() < maxChunks) {
+            chunks.push_back(unique_ptr<Chunk>(new Chunk()));
+            return chunks.back().get();
+        }
+        recycled.wait(guard, [this] { return !spare.empty(); });
+        Chunk* chunk = spare.back();
+        spare.pop_back();
+        return chunk;
+    }
+
+    // Queues a chunk from acquire() for writing. Empty chunks are simply
+    // recycled.
+    void submit(Chunk* chunk) {
+        {
+            lock_guard<mutex> guard(lock);
+            if (chunk->empty() || !file.is_open()) {
+                recycle(chunk);
+                return;
+            }
+            pending.push_back(chunk);
+        }
+        queued.notify_one();
+    }
+
+    // Writes everything queued, stops the thread and closes the file
+    bool close() {
+        if (!file.is_open()) return true;
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        queued.notify_one();
+        writer.join();
+        file.close();
+        return !file.fail();
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include "GameTypes.h"
+#include <type_traits>
+
+// Everything that differs between difficulty levels. The table is constexpr,
+// so code instantiated for one level (see RuledKingdom) sees its rules as
+// constants and the turn loop carries no difficulty branches.
+struct DifficultyRules {
+    int food;
+    int gold;
+    int wood;
+    int stone;
+    int iron;
+    int weapons;
+    int disasterInterval;   // minimum turns between disasters
+};
+
+constexpr DifficultyRules DIFFICULTY_RULES[] = {
+    // food  gold  wood  stone  iron  weapons  disasterInterval
+    { 1000, 1000, 200, 200, 150, 100, 3 },   // EASY
+    { 700, 700, 150, 150, 100, 70, 2 },      // MEDIUM
+    { 500, 500, 100, 100, 70, 50, 2 },       // HARD
+};
+
+static_assert(sizeof(DIFFICULTY_RULES) / sizeof(DIFFICULTY_RULES[0]) == HARD + 1,
+    "one rule set per difficulty");
+
+template <Difficulty D>
+constexpr const DifficultyRules& rulesFor() {
+    return DIFFICULTY_RULES[D];
+}
+
+// An out-of-range difficulty gets MEDIUM's rules, as in dispatchDifficulty
+inline const DifficultyRules& rulesFor(Difficulty diff) {
+    return DIFFICULTY_RULES[isDifficulty(diff) ? diff : MEDIUM];
+}
+
+// Carries a difficulty as a type, for generic lambdas passed to
+// dispatchDifficulty
+template <Difficulty D>
+using DifficultyTag = integral_constant<Difficulty, D>;
+
+// Calls f with the DifficultyTag of a difficulty known only at run time.
+// Dispatch once, outside the loop, and do the work inside f:
+//
+//     dispatchDifficulty(diff, [&](auto tag) {
+//         RuledKingdom<decltype(tag)::value> kingdom(seed);
+//         kingdom.play(source);
+//     });
+template <typename F>
+decltype(auto) dispatchDifficulty(Difficulty diff, F&& f) {
+    switch (diff) {
+    case EASY: return f(DifficultyTag<EASY>());
+    case HARD: return f(DifficultyTag<HARD>());
+    default: return f(DifficultyTag<MEDIUM>());
+    }
+}
@@ -0,0 +1,46 @@
+#include "Disasters.h"
+#include "Kingdom.h"
+
+const char* Disasters::name(DisasterType disaster) {
+    switch (disaster) {
+    case DISASTER_EARTHQUAKE: return "Earthquake";
+    case DISASTER_FAMINE: return "Famine";
+    case DISASTER_FLOOD: return "Flood";
+    default: return "Disaster";
+    }
+}
+
+void Disasters::applyDisaster(Kingdom& kingdom, DisasterType disaster) {
+    narrator() << "DISASTER: " << name(disaster) << " has struck the kingdom!\n";
+
+    int totalPop = kingdom.population.getTotal();
+    int peasantsLoss = static_cast<int>(totalPop * 0.2 * 0.7);
+    int merchantsLoss = static_cast<int>(totalPop * 0.2 * 0.15);
+    int nobilityLoss = static_cast<int>(totalPop * 0.2 * 0.1);
+    int soldiersLoss = static_cast<int>(totalPop * 0.2 * 0.05);
+
+    kingdom.population.lose(peasantsLoss, merchantsLoss, nobilityLoss, soldiersLoss);
+
+    kingdom.food.set(static_cast<int>(kingdom.food.get() * 0.8));
+    kingdom.gold.set(static_cast<int>(kingdom.gold.get() * 0.8));
+    kingdom.wood.set(static_cast<int>(kingdom.wood.get() * 0.8));
+    kingdom.stone.set(static_cast<int>(kingdom.stone.get() * 0.8));
+    kingdom.iron.set(static_cast<int>(kingdom.iron.get() * 0.8));
+    kingdom.weapons.set(static_cast<int>(kingdom.weapons.get() * 0.8));
+    kingdom.population.updateHappiness(-20);
+
+    switch (disaster) {
+    case DISASTER_EARTHQUAKE:
+        narrator() << "Buildings damaged! Resources lost!\n";
+        break;
+    case DISASTER_FAMINE:
+        narrator() << "Crops failed! Food halved!\n";
+        break;
+    case DISASTER_FLOOD:
+        narrator() << "Floods destroyed resources!\n";
+        break;
+    default:
+        break;
+    }
+    narrator() << "20% of resources and some population lost due to the disaster.\n";
+}
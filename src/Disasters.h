@@ -0,0 +1,17 @@
+#pragma once
+#include "GameTypes.h"
+
+class Kingdom;
+
+enum DisasterType {
+    DISASTER_EARTHQUAKE,
+    DISASTER_FAMINE,
+    DISASTER_FLOOD,
+    DISASTER_COUNT
+};
+
+class Disasters {
+public:
+    static const char* name(DisasterType disaster);
+    static void applyDisaster(Kingdom& kingdom, DisasterType disaster);
+};
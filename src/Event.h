@@ -0,0 +1,23 @@
+#pragma once
+#include "GameTypes.h"
+
+// Special handling an event needs beyond its flat deltas
+enum EventEffect {
+    EFFECT_NONE,
+    EFFECT_PLAGUE
+};
+
+class Event {
+public:
+    string description;
+    int foodChange, goldChange, happinessChange, armyChange, populationChange;
+    int id;
+    int weight;     // relative chance of being drawn from its table
+    int goldRoll;   // extra random gold in [0, goldRoll)
+    EventEffect effect;
+    Event(string desc, int food, int gold, int happy, int army, int pop,
+        int w = 1, int roll = 0, EventEffect e = EFFECT_NONE)
+        : description(desc), foodChange(food), goldChange(gold),
+        happinessChange(happy), armyChange(army), populationChange(pop),
+        id(-1), weight(w), goldRoll(roll), effect(e) {}
+};
@@ -0,0 +1,97 @@
+#include "EventTable.h"
+#include "Kingdom.h"
+
+int EventTable::add(const Event& event) {
+    events.push_back(event);
+    events.back().id = static_cast<int>(events.size()) - 1;
+    food.push_back(event.foodChange);
+    gold.push_back(event.goldChange);
+    happiness.push_back(event.happinessChange);
+    army.push_back(event.armyChange);
+    population.push_back(event.populationChange);
+    goldRoll.push_back(event.goldRoll);
+    return events.back().id;
+}
+
+void EventTable::build() {
+    size_t n = events.size();
+    double totalWeight = 0;
+    for (size_t i = 0; i < n; i++) totalWeight += events[i].weight > 0 ? events[i].weight : 0;
+    // Nothing can be drawn; sample() sees empty tables and returns -1
+    if (totalWeight <= 0) n = 0;
+    aliasProbability.assign(n, 0);
+    alias.assign(n, 0);
+    if (n == 0) return;
+
+    vector<double> scaled(n);
+    vector<int> small, large;
+    for (size_t i = 0; i < n; i++) {
+        scaled[i] = (events[i].weight > 0 ? events[i].weight : 0) * n / totalWeight;
+        if (scaled[i] < 1.0) small.push_back(static_cast<int>(i));
+        else large.push_back(static_cast<int>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+        aliasProbability[s] = static_cast<uint64_t>(scaled[s] * 4294967296.0);
+        alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // whatever is left is (up to rounding) exactly 1
+    for (size_t i = 0; i < large.size(); i++) aliasProbability[large[i]] = 4294967296ULL;
+    for (size_t i = 0; i < small.size(); i++) aliasProbability[small[i]] = 4294967296ULL;
+}
+
+int EventTable::sample(Random& rng) const {
+    if (aliasProbability.empty()) return -1;
+    uint64_t raw = rng.nextRaw();
+    uint64_t column = ((raw >> 32) * aliasProbability.size()) >> 32;
+    return (raw & 0xFFFFFFFFULL) < aliasProbability[column] ? static_cast<int>(column) : alias[column];
+}
+
+void EventTable::apply(int id, Kingdom& kingdom, Random& rng) const {
+    const Event& event = events[id];
+    if (event.effect == EFFECT_PLAGUE) {
+        int plagueDeaths = kingdom.population.getTotal() * 0.1;
+        narrator() << "A plague has killed " << plagueDeaths << " people!\n";
+        kingdom.population.plague();
+    }
+
+    int goldDelta = gold[id];
+    if (goldRoll[id] > 0) goldDelta += rng.next(goldRoll[id]);
+
+    if (!event.description.empty()) {
+        narrator() << event.description;
+        if (goldRoll[id] > 0) narrator() << " +" << goldDelta << " gold.";
+        narrator() << "\n";
+    }
+
+    if (food[id] > 0) kingdom.food.add(food[id]);
+    else if (food[id] < 0) kingdom.food.remove(-food[id]);
+    if (goldDelta > 0) kingdom.gold.add(goldDelta);
+    else if (goldDelta < 0) kingdom.gold.remove(-goldDelta);
+    if (happiness[id] != 0) kingdom.population.updateHappiness(happiness[id]);
+    if (army[id] != 0) kingdom.army.addSoldiers(army[id]);
+    if (population[id] > 0) kingdom.population.addPeasants(population[id]);
+    else if (population[id] < 0) kingdom.population.removePeasants(-population[id]);
+}
+
+const EventTable& EventTable::standard() {
+    static const EventTable table = [] {
+        EventTable t;
+        t.add(Event("", 0, 0, 0, 0, 0, 1, 0, EFFECT_PLAGUE));
+        t.add(Event("Miners found a gold vein!", 0, 100, 0, 0, 0, 1, 200));
+        t.add(Event("Merchants report increased trade! Happiness +5", 0, 0, 5, 0, 0));
+        t.add(Event("Bandits attacked a trade route! Gold -50", 0, -50, 0, 0, 0));
+        t.add(Event("Good harvest this season! Food +200", 200, 0, 0, 0, 0));
+        t.add(Event("", 0, 0, 0, 0, 0, 5)); // a quiet season
+        t.build();
+        return t;
+    }();
+    return table;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "GameTypes.h"
+#include "Event.h"
+#include "Random.h"
+
+class Kingdom;
+
+// Weighted set of events, built once and then shared read-only by every
+// kingdom. Events are referred to by their integer id (their index), the
+// per-event deltas are kept in flat arrays, and sample() draws an id in O(1)
+// with Vose's alias method, so the turn loop never touches a string.
+class EventTable {
+private:
+    vector<Event> events;
+    vector<int> food, gold, happiness, army, population, goldRoll;
+    vector<uint64_t> aliasProbability; // chance, scaled to 2^32, of keeping column i
+    vector<int> alias;
+
+public:
+    EventTable() {}
+
+    // Appends an event and returns its id. sample() only sees events added
+    // before the last build().
+    int add(const Event& event);
+
+    // Builds the alias tables sample() draws from, in O(n); call once after
+    // the last add()
+    void build();
+
+    size_t size() const {
+        return events.size();
+    }
+
+    const Event& operator[](int id) const {
+        return events[id];
+    }
+
+    // A weighted random event id, or -1 (no event) if the table is empty,
+    // unbuilt, or every weight is zero
+    int sample(Random& rng) const;
+
+    // Applies event id to a kingdom and narrates it
+    void apply(int id, Kingdom& kingdom, Random& rng) const;
+
+    // The game's built-in random events
+    static const EventTable& standard();
+};
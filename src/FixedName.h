@@ -0,0 +1,53 @@
+#pragma once
+#include "GameTypes.h"
+#include <cstring>
+
+// Name stored inline instead of in a std::string, so the objects holding it
+// stay trivially copyable. Longer names are truncated to N - 1 characters.
+template <size_t N>
+class FixedName {
+private:
+    char text[N];
+
+    void assign(const char* s, size_t length) {
+        if (length > N - 1) length = N - 1;
+        memcpy(text, s, length);
+        memset(text + length, 0, N - length);
+    }
+
+public:
+    FixedName() {
+        memset(text, 0, N);
+    }
+
+    FixedName(const char* s) {
+        assign(s, strlen(s));
+    }
+
+    FixedName(const string& s) {
+        assign(s.data(), s.size());
+    }
+
+    FixedName(const char* s, size_t length) {
+        assign(s, length);
+    }
+
+    const char* c_str() const {
+        return text;
+    }
+
+    string str() const {
+        return string(text);
+    }
+
+    bool operator==(const FixedName& other) const {
+        return strcmp(text, other.text) == 0;
+    }
+
+    friend ostream& operator<<(ostream& out, const FixedName& name) {
+        return out << name.text;
+    }
+};
+
+const size_t NAME_LENGTH = 32;
+typedef FixedName<NAME_LENGTH> Name;
@@ -0,0 +1,358 @@
+#include "GameServer.h"
+#include "Narrator.h"
+#include "Autosave.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Actions per pool chunk; a turn takes a few hundred nanoseconds
+static const size_t BATCH_GRAIN = 64;
+static const size_t READ_SIZE = 64 * 1024;
+// Unsent replies at which a connection stops being read and parsed
+static const size_t OUTPUT_LIMIT = 256 * 1024;
+static const int MAX_EVENTS = 256;
+
+GameServer::GameServer(unsigned threads, size_t sessionLimit) :
+    pool(threads), epoll(epoll_create1(EPOLL_CLOEXEC)), listener(-1),
+    wakeup(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), stopping(false), maxSessions(sessionLimit), autosave(nullptr) {
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeup;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &event);
+}
+
+GameServer::~GameServer() {
+    vector<int> open;
+    for (auto& entry : connections) open.push_back(entry.first);
+    for (size_t i = 0; i < open.size(); i++) closeConnection(open[i]);
+    if (listener >= 0) close(listener);
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+    close(wakeup);
+    close(epoll);
+}
+
+bool GameServer::listenOn(int fd) {
+    if (listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return false;
+    }
+    listener = fd;
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    return epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event) == 0;
+}
+
+bool GameServer::listenUnix(const string& path) {
+    sockaddr_un address = {};
+    if (listener >= 0 || path.size() >= sizeof(address.sun_path)) return false;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return false;
+    }
+    unixPath = path;
+    return listenOn(fd);
+}
+
+bool GameServer::listenTcp(uint16_t port, bool local) {
+    if (listener >= 0) return false;
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(local ? INADDR_LOOPBACK : INADDR_ANY);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return false;
+    }
+    return listenOn(fd);
+}
+
+void GameServer::autosaveTo(Autosaver* saver) {
+    autosave = saver;
+    if (saver && maxSessions > saver->size()) maxSessions = saver->size();
+}
+
+void GameServer::accept() {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        int on = 1;
+        // Replies are small and latency-bound; fails harmlessly on Unix sockets
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+        connections[fd];
+        stats.connections++;
+    }
+}
+
+void GameServer::closeConnection(int fd) {
+    auto found = connections.find(fd);
+    if (found == connections.end()) return;
+    const vector<uint32_t>& owned = found->second.sessions;
+    for (size_t i = 0; i < owned.size(); i++) {
+        dropBatched(owned[i]);
+        sessions[owned[i]].owner = -1;
+        freeSessions.push_back(owned[i]);
+    }
+    stats.sessions -= owned.size();
+    connections.erase(found);
+    epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+}
+
+// A session that is closed while its action waits in the batch may be
+// reopened by a new game in the same pass, so the action must not run
+void GameServer::dropBatched(uint32_t session) {
+    if (!sessions[session].queued) return;
+    for (size_t i = 0; i < batch.size(); i++) {
+        if (batch[i].session == session) batch[i].connection = -1;
+    }
+    sessions[session].queued = false;
+}
+
+void GameServer::receive(int fd, Connection& connection) {
+    // Drop what was parsed on earlier passes before reading more
+    if (connection.parsed > 0) {
+        connection.in.erase(0, connection.parsed);
+        connection.parsed = 0;
+    }
+    size_t used = connection.in.size();
+    connection.in.resize(used + READ_SIZE);
+    ssize_t got = read(fd, &connection.in[used], READ_SIZE);
+    if (got <= 0) {
+        connection.in.resize(used);
+        if (got == 0 || (errno != EAGAIN && errno != EINTR)) closeConnection(fd);
+        return;
+    }
+    connection.in.resize(used + got);
+    parse(fd, connection);
+}
+
+void GameServer::parse(int fd, Connection& connection) {
+    connection.pending = false;
+    touched.push_back(fd);
+    const char* data = connection.in.data();
+    size_t available = connection.in.size();
+    while (true) {
+        if (connection.out.size() >= OUTPUT_LIMIT) {
+            // The client is not reading its replies; wait until they drain
+            connection.throttled = true;
+            return;
+        }
+        size_t size = frameSize(data + connection.parsed, available - connection.parsed);
+        if (size == 0) return;
+        const char* frame = data + connection.parsed;
+        ClientRequest request;
+        if (!decodeRequest(frame, request)) {
+            putError(connection.out, request.tag, ERROR_BAD_REQUEST);
+            connection.parsed += size;
+            continue;
+        }
+        if (request.type == MSG_ACTION && request.session < sessions.size()
+            && sessions[request.session].owner == fd && sessions[request.session].queued) {
+            // Keep this session's actions in order: the rest waits a pass
+            connection.pending = true;
+            pendingConnections.push_back(fd);
+            return;
+        }
+        connection.parsed += size;
+        handle(fd, connection, request);
+    }
+}
+
+void GameServer::handle(int fd, Connection& connection, const ClientRequest& request) {
+    int values[FIELD_COUNT];
+    switch (request.type) {
+    case MSG_NEW_GAME: {
+        uint32_t id;
+        if (!freeSessions.empty()) {
+            id = freeSessions.back();
+            freeSessions.pop_back();
+        }
+        else if (sessions.size() < maxSessions) {
+            id = static_cast<uint32_t>(sessions.size());
+            sessions.push_back(Session());
+        }
+        else {
+            putError(connection.out, request.tag, ERROR_BUSY);
+            return;
+        }
+        Session& session = sessions[id];
+        session.kingdom = Kingdom(request.difficulty, request.seed);
+        session.owner = fd;
+        session.queued = false;
+        connection.sessions.push_back(id);
+        stats.sessions++;
+        if (autosave) autosave->capture(id, session.kingdom);
+        captureStatus(session.kingdom, values);
+        putStatus(connection.out, request.tag, id, 0, OUTCOME_IN_PROGRESS, values);
+        return;
+    }
+    case MSG_ACTION: {
+        if (request.session >= sessions.size() || sessions[request.session].owner != fd) {
+            putError(connection.out, request.tag, ERROR_NO_SESSION);
+            return;
+        }
+        sessions[request.session].queued = true;
+        BatchItem item;
+        item.connection = fd;
+        item.tag = request.tag;
+        item.session = request.session;
+        item.action = request.action;
+        batch.push_back(item);
+        return;
+    }
+    case MSG_END_GAME: {
+        vector<uint32_t>& owned = connection.sessions;
+        for (size_t i = 0; i < owned.size(); i++) {
+            if (owned[i] != request.session) continue;
+            owned[i] = owned.back();
+            owned.pop_back();
+            dropBatched(request.session);
+            sessions[request.session].owner = -1;
+            freeSessions.push_back(request.session);
+            stats.sessions--;
+            return;
+        }
+        return;
+    }
+    default:
+        return;
+    }
+}
+
+void GameServer::runBatch() {
+    stats.batches++;
+    stats.actions += batch.size();
+    pool.parallelFor(batch.size(), BATCH_GRAIN, [this](unsigned, size_t begin, size_t end) {
+        Narrator previous = narrator();
+        narrator().mute();
+        for (size_t i = begin; i < end; i++) {
+            BatchItem& item = batch[i];
+            if (item.connection < 0) continue;
+            Kingdom& kingdom = sessions[item.session].kingdom;
+            // A quit with "save" is kept by this capture; the server never
+            // writes the player's text save
+            bool accepted = kingdom.step(item.action);
+            if (autosave) autosave->capture(item.session, kingdom);
+            item.flags = (accepted ? STATUS_ACCEPTED : 0) | (kingdom.isGameOver() ? STATUS_GAME_OVER : 0);
+            item.outcome = static_cast<uint8_t>(kingdom.getOutcome());
+            captureStatus(kingdom, item.values);
+        }
+        narrator() = previous;
+    });
+    for (size_t i = 0; i < batch.size(); i++) {
+        const BatchItem& item = batch[i];
+        if (item.connection < 0) continue;
+        sessions[item.session].queued = false;
+        putStatus(connections[item.connection].out, item.tag, item.session, item.flags, item.outcome,
+            item.values);
+    }
+    batch.clear();
+}
+
+void GameServer::flush(int fd, Connection& connection) {
+    if (connection.writable && !connection.out.empty()) {
+        ssize_t sent = write(fd, connection.out.data(), connection.out.size());
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EINTR) {
+                closeConnection(fd);
+                return;
+            }
+            sent = 0;
+        }
+        connection.out.erase(0, sent);
+    }
+    if (connection.throttled && connection.out.size() < OUTPUT_LIMIT) {
+        // Parse the frames it held back on the next pass
+        connection.throttled = false;
+        connection.pending = true;
+        pendingConnections.push_back(fd);
+    }
+    if (connection.out.empty()) return;
+    // The socket is full: wait until it drains, without reading from a
+    // throttled connection meanwhile
+    connection.writable = false;
+    epoll_event event = {};
+    event.events = connection.throttled ? EPOLLOUT : EPOLLIN | EPOLLRDHUP | EPOLLOUT;
+    event.data.fd = fd;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+}
+
+void GameServer::run() {
+    epoll_event events[MAX_EVENTS];
+    vector<int> retry;
+    while (!stopping.load(memory_order_relaxed)) {
+        // Frames held back last pass are ready now, so do not block
+        int count = epoll_wait(epoll, events, MAX_EVENTS, pendingConnections.empty() ? -1 : 0);
+        if (count < 0 && errno != EINTR) break;
+
+        retry.swap(pendingConnections);
+        pendingConnections.clear();
+        for (size_t i = 0; i < retry.size(); i++) {
+            auto found = connections.find(retry[i]);
+            if (found != connections.end() && found->second.pending) parse(retry[i], found->second);
+        }
+
+        for (int e = 0; e < count; e++) {
+            int fd = events[e].data.fd;
+            if (fd == wakeup) continue;
+            if (fd == listener) {
+                accept();
+                continue;
+            }
+            auto found = connections.find(fd);
+            if (found == connections.end()) continue;
+            Connection& connection = found->second;
+            if (events[e].events & EPOLLOUT) {
+                connection.writable = true;
+                touched.push_back(fd);
+                epoll_event event = {};
+                event.events = EPOLLIN | EPOLLRDHUP;
+                event.data.fd = fd;
+                epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+            }
+            if (events[e].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                // A connection that is still holding frames back reads later
+                if (!connection.pending && !connection.throttled) receive(fd, connection);
+            }
+        }
+
+        if (!batch.empty()) runBatch();
+        for (size_t i = 0; i < touched.size(); i++) {
+            auto found = connections.find(touched[i]);
+            if (found != connections.end()) flush(touched[i], found->second);
+        }
+        touched.clear();
+    }
+}
+
+void GameServer::stop() {
+    stopping.store(true);
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeup, &one, sizeof(one));
+    (void)ignored;
+}
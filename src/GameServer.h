@@ -0,0 +1,121 @@
+#pragma once
+#include "GameTypes.h"
+#include "Kingdom.h"
+#include "ServerProtocol.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <unordered_map>
+
+class Autosaver;
+
+struct ServerStats {
+    uint64_t connections;   // accepted so far
+    uint64_t sessions;      // open now
+    uint64_t actions;       // actions applied
+    uint64_t batches;       // turn batches handed to the pool
+
+    ServerStats() : connections(0), sessions(0), actions(0), batches(0) {}
+};
+
+// Hosts many kingdoms in one process behind a Unix-domain or TCP socket
+// (Linux only; built on epoll). Clients speak the protocol in
+// ServerProtocol.h, and a connection may run any number of sessions.
+//
+// One thread runs the event loop. Each pass reads every ready connection,
+// decodes the complete frames, applies the actions of that pass as one
+// batch on the worker pool, and then writes all replies. A session's
+// actions are applied in order. When a connection holds a second action for
+// a session that is already in the batch, parsing of that connection stops
+// there and resumes on the next pass. Likewise a connection whose unsent
+// replies pass a limit is neither read nor parsed until they drain.
+class GameServer {
+private:
+    struct Session {
+        Kingdom kingdom;
+        int owner;        // connection fd, -1 when free
+        bool queued;      // has an action in the current batch
+
+        Session() : kingdom(MEDIUM), owner(-1), queued(false) {}
+    };
+
+    struct Connection {
+        string in;
+        size_t parsed;    // bytes of `in` already handled
+        string out;
+        bool writable;    // false while waiting for EPOLLOUT
+        bool pending;     // holds complete frames not yet parsed
+        bool throttled;   // too many unsent replies: not read or parsed
+        vector<uint32_t> sessions;
+
+        Connection() : parsed(0), writable(true), pending(false), throttled(false) {}
+    };
+
+    // One action of the current batch; the worker fills in the reply
+    struct BatchItem {
+        int connection;
+        uint32_t tag;
+        uint32_t session;
+        PlayerAction action;
+        uint8_t flags;
+        uint8_t outcome;
+        int values[FIELD_COUNT];
+    };
+
+    WorkStealingPool pool;
+    int epoll;
+    int listener;
+    int wakeup;                 // eventfd that stop() signals
+    string unixPath;
+    atomic<bool> stopping;
+    size_t maxSessions;
+    vector<Session> sessions;
+    vector<uint32_t> freeSessions;
+    unordered_map<int, Connection> connections;
+    vector<int> pendingConnections;
+    vector<int> touched;        // connections that may have replies to send
+    vector<BatchItem> batch;
+    Autosaver* autosave;
+    ServerStats stats;
+
+    bool listenOn(int fd);
+    void accept();
+    void closeConnection(int fd);
+    void dropBatched(uint32_t session);
+    void receive(int fd, Connection& connection);
+    void parse(int fd, Connection& connection);
+    void handle(int fd, Connection& connection, const ClientRequest& request);
+    void runBatch();
+    void flush(int fd, Connection& connection);
+
+public:
+    explicit GameServer(unsigned threads = 0, size_t sessionLimit = 65536);
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // Binds and listens; an existing socket file at path is replaced
+    bool listenUnix(const string& path);
+
+    // Listens on 127.0.0.1, or on all interfaces when `local` is false
+    bool listenTcp(uint16_t port, bool local = true);
+
+    // Captures every session into the autosaver slot of its id after each
+    // turn, and caps the session count at the autosaver's size
+    void autosaveTo(Autosaver* saver);
+
+    // Serves until stop() is called
+    void run();
+
+    // Makes run() return; safe from any thread or a signal handler
+    void stop();
+
+    unsigned threadCount() const {
+        return pool.size();
+    }
+
+    // Read after run() returns, or from the loop thread
+    const ServerStats& getStats() const {
+        return stats;
+    }
+};
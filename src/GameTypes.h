@@ -0,0 +1,89 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+enum Difficulty { EASY, MEDIUM, HARD };
+
+// For values read from users and files before they are cast to Difficulty
+inline bool isDifficulty(int value) {
+    return value >= EASY && value <= HARD;
+}
+
+// How a game ended, as decided by Kingdom::checkGameOver (or the quit action)
+enum GameOutcome {
+    OUTCOME_IN_PROGRESS,
+    OUTCOME_WIN,
+    OUTCOME_EXTINCT,
+    OUTCOME_STARVED,
+    OUTCOME_BANKRUPT,
+    OUTCOME_REVOLT,
+    OUTCOME_CONQUERED,
+    OUTCOME_QUIT,
+    OUTCOME_COUNT
+};
+
+inline const char* outcomeName(GameOutcome outcome) {
+    switch (outcome) {
+    case OUTCOME_IN_PROGRESS: return "in_progress";
+    case OUTCOME_WIN: return "win";
+    case OUTCOME_EXTINCT: return "extinct";
+    case OUTCOME_STARVED: return "starved";
+    case OUTCOME_BANKRUPT: return "bankrupt";
+    case OUTCOME_REVOLT: return "revolt";
+    case OUTCOME_CONQUERED: return "conquered";
+    case OUTCOME_QUIT: return "quit";
+    default: return "unknown";
+    }
+}
+
+// Goods traded on the exchange; each maps to one of the kingdom's inventories
+enum Commodity {
+    COMMODITY_FOOD,
+    COMMODITY_WEAPONS,
+    COMMODITY_WOOD,
+    COMMODITY_STONE,
+    COMMODITY_IRON,
+    COMMODITY_COUNT
+};
+
+inline const char* commodityName(Commodity commodity) {
+    switch (commodity) {
+    case COMMODITY_FOOD: return "food";
+    case COMMODITY_WEAPONS: return "weapons";
+    case COMMODITY_WOOD: return "wood";
+    case COMMODITY_STONE: return "stone";
+    case COMMODITY_IRON: return "iron";
+    default: return "unknown";
+    }
+}
+
+enum OrderSide { SIDE_BUY, SIDE_SELL };
+
+// Values 0-8 match the in-game action menu
+enum ActionType : int {
+    ACTION_INVALID = -1,     // anything not on the menu; step() rejects it
+    ACTION_QUIT,
+    ACTION_COLLECT_TAXES,
+    ACTION_SET_TAX_RATE,
+    ACTION_RECRUIT,
+    ACTION_TRAIN,
+    ACTION_TRADE_FOOD,
+    ACTION_BUILD_FARM,
+    ACTION_BUILD_BARRACKS,
+    ACTION_TAKE_LOAN,
+    ACTION_WAIT
+};
+
+// One player decision. amount is the tax rate / recruits / food / loan size,
+// option is buy(1) or sell(2) for food, the loan term, or save(1) on quit.
+struct PlayerAction {
+    ActionType type;
+    int amount;
+    int option;
+    PlayerAction(ActionType t = ACTION_WAIT, int a = 0, int o = 0) : type(t), amount(a), option(o) {}
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include "Narrator.h"
+#include "Zobrist.h"
+
+template <typename T>
+class Inventory {
+private:
+    T quantity;
+    HashField field;
+    uint64_t zobrist;   // key of (field, quantity), kept current by every change
+public:
+    Inventory(T q = 0, HashField f = HASH_NONE) : quantity(q), field(f), zobrist(zobristKey(f, q)) {}
+    void add(T amount) {
+        quantity += amount;
+        zobrist = zobristKey(field, quantity);
+    }
+
+    void remove(T amount) {
+        if (amount > quantity) {
+            narrator() << "Not enough resources\n";
+            return;
+        }
+        quantity -= amount;
+        zobrist = zobristKey(field, quantity);
+    }
+
+    T get() const {return quantity;
+    }
+
+    void set(T q) {
+        quantity = q;
+        zobrist = zobristKey(field, quantity);
+    }
+
+    uint64_t hash() const {
+        return zobrist;
+    }
+};
@@ -0,0 +1,500 @@
+#include "Kingdom.h"
+#include "ActionSource.h"
+#include "Profiler.h"
+#include "Disasters.h"
+#include "KingdomArchive.h"
+#include "StatusRenderer.h"
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+
+Kingdom::Kingdom(Difficulty diff, uint64_t seed) :
+    turn(1),
+    difficulty(isDifficulty(diff) ? diff : MEDIUM),
+    currentKing("King_1"),
+    population(100, 20, 10, 30, 70),
+    army(30, 50, 60),
+    food(0, HASH_FOOD),
+    gold(0, HASH_GOLD),
+    wood(0, HASH_WOOD),
+    stone(0, HASH_STONE),
+    iron(0, HASH_IRON),
+    weapons(0, HASH_WEAPONS),
+    lastDisasterTurn(-5),
+    lastWarTurn(-5),
+    lastElectionTurn(0),
+    lastEvent(-1),
+    gameOver(false),
+    outcome(OUTCOME_IN_PROGRESS),
+    saveRequested(false),
+    rng(seed),
+    recorder(nullptr),
+    events(&EventTable::standard()),
+    balance(&BalanceParams::standard()) {
+
+    rng.beginTurn(turn);
+
+    const DifficultyRules& rules = rulesFor(difficulty);
+    food.set(rules.food);
+    gold.set(rules.gold);
+    wood.set(rules.wood);
+    stone.set(rules.stone);
+    iron.set(rules.iron);
+    weapons.set(rules.weapons);
+}
+
+Inventory<int>& Kingdom::stock(Commodity commodity) {
+    switch (commodity) {
+    case COMMODITY_FOOD: return food;
+    case COMMODITY_WEAPONS: return weapons;
+    case COMMODITY_WOOD: return wood;
+    case COMMODITY_STONE: return stone;
+    default: return iron;
+    }
+}
+
+const Inventory<int>& Kingdom::stock(Commodity commodity) const {
+    return const_cast<Kingdom*>(this)->stock(commodity);
+}
+
+static_assert(HASH_HAPPINESS - HASH_CLASS == CLASS_COUNT, "one hash field per social class");
+static_assert(HASH_LOAN_TERM - HASH_LOAN == MAX_LOANS && HASH_LOAN_RATE - HASH_LOAN_TERM == MAX_LOANS &&
+    HASH_LOAN_PAYMENT - HASH_LOAN_RATE == MAX_LOANS, "one hash field per loan slot");
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+uint64_t Kingdom::hash() const {
+    // Kept up to date by the components themselves
+    uint64_t h = food.hash() ^ gold.hash() ^ wood.hash() ^ stone.hash() ^ iron.hash() ^ weapons.hash()
+        ^ population.hash() ^ buildings.hash();
+
+    h ^= zobristKey(HASH_TURN, turn) ^ zobristKey(HASH_DIFFICULTY, difficulty)
+        ^ zobristKey(HASH_OUTCOME, gameOver ? outcome : -1)
+        ^ zobristKey(HASH_LAST_DISASTER, lastDisasterTurn) ^ zobristKey(HASH_LAST_WAR, lastWarTurn)
+        ^ zobristKey(HASH_LAST_ELECTION, lastElectionTurn) ^ zobristKey(HASH_TAX_RATE, currentKing.taxRate);
+    h ^= zobristKey(HASH_ARMY_SOLDIERS, army.getSoldiers()) ^ zobristKey(HASH_ARMY_WEAPONS, army.getWeapons())
+        ^ zobristKey(HASH_MORALE, army.getMorale()) ^ zobristKey(HASH_AT_WAR, army.isInWar());
+    h ^= zobristKey(HASH_BANK_RESERVE, bank.getReserve()) ^ zobristKey(HASH_BANK_TRUST, floatBits(bank.getTrustRate()));
+    const LoanLedger& loans = bank.getLoans();
+    for (int i = 0; i < MAX_LOANS; i++) {
+        if (loans.balance[i] == 0.0f) continue;
+        // Each value stays within 32 bits, below the field bits of its key
+        h ^= zobristKey(HASH_LOAN + i, floatBits(loans.balance[i]))
+            ^ zobristKey(HASH_LOAN_RATE + i, floatBits(loans.rate[i]))
+            ^ zobristKey(HASH_LOAN_PAYMENT + i, floatBits(loans.payment[i]))
+            ^ zobristKey(HASH_LOAN_TERM + i, static_cast<uint32_t>(loans.turnsLeft[i]));
+    }
+    h ^= zobristKey(HASH_FOOD_PRICE, market.getFoodPrice()) ^ zobristKey(HASH_WEAPON_PRICE, market.getWeaponPrice());
+    return h;
+}
+
+void Kingdom::randomEvent() {
+    lastEvent = events->sample(rng);
+    if (lastEvent >= 0) events->apply(lastEvent, *this, rng);
+}
+
+void Kingdom::checkElection() {
+    if (turn - lastElectionTurn >= 5) {
+        narrator() << "\n=== ELECTION TIME ===\n";
+        int approval = population.getHappiness() / 2 + rng.next(30);
+
+        if (approval < 40) {
+            narrator() << "The people are unhappy! " << currentKing.name << " has been overthrown!\n";
+            char kingName[NAME_LENGTH];
+            snprintf(kingName, sizeof(kingName), "King_%d", turn);
+            currentKing = King(kingName);
+            population.updateHappiness(20); // New king happiness boost
+        }
+        else {
+            narrator() << currentKing.name << " remains in power with " << approval << "% approval.\n";
+        }
+
+        lastElectionTurn = turn;
+    }
+}
+
+void Kingdom::checkGameOver() {
+    if (population.getTotal() <= 0) {
+        narrator() << "GAME OVER: Everyone has died. The kingdom has fallen.\n";
+        gameOver = true;
+        outcome = OUTCOME_EXTINCT;
+        return;
+    }
+    if (food.get() <= 0) {
+        narrator() << "GAME OVER: No food left. The kingdom has starved.\n";
+        gameOver = true;
+        outcome = OUTCOME_STARVED;
+        return;
+    }
+    if (gold.get() < -1000) {
+        narrator() << "GAME OVER: The kingdom is bankrupt.\n";
+        gameOver = true;
+        outcome = OUTCOME_BANKRUPT;
+        return;
+    }
+    if (population.getHappiness() <= 10) {
+        narrator() << "GAME OVER: The people have revolted and overthrown the kingdom.\n";
+        gameOver = true;
+        outcome = OUTCOME_REVOLT;
+        return;
+    }
+    if (army.getSoldiers() == 0 && rng.next(10) == 0) {
+        narrator() << "GAME OVER: Enemy kingdom attacked and conquered your defenseless land.\n";
+        gameOver = true;
+        outcome = OUTCOME_CONQUERED;
+        return;
+    }
+    if (turn >= balance->winTurn) {
+        narrator() << "\n\n=== YOU WIN! ===\n";
+        narrator() << "Your kingdom has survived " << balance->winTurn << " turns and proven its stability!\n";
+        gameOver = true;
+        outcome = OUTCOME_WIN;
+        return;
+    }
+}
+
+void Kingdom::showStatus() const {
+    narrator() << "\n--------------------------\n";
+    narrator() << "Loading kingdom status...\n";
+    narrator() << "--------------------------\n";
+
+    narrator().pause(2000);
+    narrator().clearScreen();
+
+    narrator() << "\n=== KINGDOM STATUS (Turn " << turn << ") ===\n";
+    narrator() << "King: " << currentKing.name << "\n";
+    narrator() << "Tax: " << currentKing.taxRate << "%\n";
+    narrator() << "Population: " << population.getTotal() << "\n";
+    narrator() << "Happiness: " << population.getHappiness() << "%\n";
+    narrator() << "Food: " << food.get() << "\n";
+    narrator() << "Gold: " << gold.get() << "\n";
+    narrator() << "Resources: Wood=" << wood.get() << " Stone=" << stone.get()
+        << " Iron=" << iron.get() << " Weapons=" << weapons.get() << "\n";
+    const LoanLedger& loans = bank.getLoans();
+    if (loans.activeCount() > 0) {
+        narrator() << "Debt: " << static_cast<int>(ceil(loans.outstanding())) << " gold over "
+            << loans.activeCount() << " loans (Trust: " << bank.getTrustRate() * 100 << "%)\n";
+    }
+    narrator() << "Army: " << army.getSoldiers() << " soldiers (Morale: " << army.getMorale() << "%)\n";
+    narrator() << "Buildings: Farms=" << buildings.getFarms() << " Barracks=" << buildings.getBarracks() << "\n";
+    narrator() << "------------------------------------\n";
+
+}
+
+void Kingdom::economyPhase() {
+    // Consume food
+    {
+        PROFILE_PHASE(PHASE_FOOD);
+        int foodConsumption = population.getTotal() / 2;
+        food.remove(foodConsumption);
+        narrator() << "Consumed " << foodConsumption << " food.\n";
+    }
+
+    // Pay soldiers
+    {
+        PROFILE_PHASE(PHASE_PAY_SOLDIERS);
+        army.paySoldiers(army.getSoldiers() * balance->soldierPay, gold);
+    }
+
+    // Produce resources
+    {
+        PROFILE_PHASE(PHASE_PRODUCE);
+        buildings.produceResources(food, iron, *balance);
+    }
+
+    // Loan interest and installments
+    {
+        PROFILE_PHASE(PHASE_LOANS);
+        bank.collectInstallments(gold);
+    }
+}
+
+void Kingdom::nextTurn() {
+    dispatchDifficulty(difficulty, [this](auto tag) { advanceTurn<decltype(tag)::value>(); });
+}
+
+template <Difficulty D>
+void Kingdom::advanceTurn() {
+    constexpr DifficultyRules rules = rulesFor<D>();
+    if (gameOver) return;
+
+    turn++;
+    rng.beginTurn(turn);
+    narrator() << "\n=== TURN " << turn << " BEGINS ===\n";
+
+    economyPhase();
+
+    // Births, deaths, aging and class migration
+    {
+        PROFILE_PHASE(PHASE_DEMOGRAPHY);
+        population.advance();
+    }
+
+    // Random events
+    {
+        PROFILE_PHASE(PHASE_EVENTS);
+        if (rng.next(4) == 0) {
+            randomEvent();
+        }
+    }
+
+    // Check for elections
+    {
+        PROFILE_PHASE(PHASE_ELECTION);
+        checkElection();
+    }
+
+    // Check for disasters
+    {
+        PROFILE_PHASE(PHASE_DISASTERS);
+        if (turn - lastDisasterTurn >= rules.disasterInterval) {
+            //Disasters::applyDisaster(*this, static_cast<DisasterType>(rng.next(DISASTER_COUNT)));
+            lastDisasterTurn = turn;
+        }
+    }
+
+    // Update market prices
+    {
+        PROFILE_PHASE(PHASE_MARKET);
+        market.updatePrices(rng);
+    }
+
+    // Check game over conditions
+    {
+        PROFILE_PHASE(PHASE_GAME_OVER);
+        checkGameOver();
+    }
+}
+
+int Kingdom::advance(int turns) {
+    return dispatchDifficulty(difficulty, [&](auto tag) { return advanceWith<decltype(tag)::value>(turns); });
+}
+
+template <Difficulty D>
+int Kingdom::advanceWith(int turns) {
+    int played = 0;
+    while (played < turns && !gameOver) {
+        advanceTurn<D>();
+        played++;
+    }
+    return played;
+}
+
+bool Kingdom::performAction(const PlayerAction& action) {
+    PROFILE_PHASE(PHASE_ACTION);
+    switch (action.type) {
+    case ACTION_COLLECT_TAXES: {
+        int taxAmount = (population.getTotal() * currentKing.taxRate) / 100;
+        gold.add(taxAmount);
+        population.updateHappiness(-5);
+        narrator() << "Collected " << taxAmount << " gold in taxes. Happiness -5.\n";
+        return true;
+    }
+    case ACTION_SET_TAX_RATE: {
+        currentKing.setTaxRate(action.amount);
+        return true;
+    }
+    case ACTION_RECRUIT: {
+        army.recruit(action.amount, population, *balance);
+        return true;
+    }
+    case ACTION_TRAIN: {
+        army.train();
+        return true;
+    }
+    case ACTION_TRADE_FOOD: {
+        if (action.option == 1) {
+            market.buyFood(action.amount, food, gold);
+        }
+        else {
+            market.sellFood(action.amount, food, gold, *balance);
+        }
+        return true;
+    }
+    case ACTION_BUILD_FARM: {
+        buildings.buildFarm(wood, stone, *balance);
+        return true;
+    }
+    case ACTION_BUILD_BARRACKS: {
+        buildings.buildBarracks(wood, stone, *balance);
+        narrator() << "---------------------------\n";
+        randomEvent();
+        return true;
+    }
+    case ACTION_TAKE_LOAN: {
+        bank.giveLoan(action.amount, action.option, gold);
+        narrator() << "--------------------------\n";
+        return true;
+    }
+    case ACTION_WAIT: {
+        return true;
+    }
+    case ACTION_QUIT: {
+        gameOver = true;
+        outcome = OUTCOME_QUIT;
+        if (action.option == 1) {
+            saveRequested = true;
+            narrator() << "Game exited.\n";
+        }
+        else if (action.option == 0) {
+            narrator() << "Game not saved and exited.\n";
+        }
+        return false;
+    }
+    default: {
+        narrator() << "Invalid choice.\n";
+        return false;
+    }
+    }
+}
+
+bool Kingdom::step(const PlayerAction& action) {
+    return dispatchDifficulty(difficulty, [&](auto tag) { return stepWith<decltype(tag)::value>(action); });
+}
+
+template <Difficulty D>
+bool Kingdom::stepWith(const PlayerAction& action) {
+    if (gameOver) return false;
+    if (recorder) recorder->append(action);
+    lastEvent = -1;
+    if (!performAction(action)) return false;
+    advanceTurn<D>();
+    return true;
+}
+
+void Kingdom::playerTurn(ActionSource& source) {
+    if (gameOver) return;
+
+    showStatus();
+    step(source.nextAction(*this));
+}
+
+void Kingdom::playerTurn() {
+    ConsoleActionSource console;
+    playerTurn(console);
+}
+
+void Kingdom::playerTurn(ActionSource& source, StatusRenderer& display) {
+    if (gameOver) return;
+
+    display.render(*this);
+    step(source.nextAction(*this));
+}
+
+void Kingdom::play(ActionSource& source) {
+    dispatchDifficulty(difficulty, [&](auto tag) {
+        while (!gameOver) {
+            playTurnWith<decltype(tag)::value>(source);
+        }
+    });
+}
+
+void Kingdom::playTurn(ActionSource& source) {
+    dispatchDifficulty(difficulty, [&](auto tag) { playTurnWith<decltype(tag)::value>(source); });
+}
+
+template <Difficulty D>
+void Kingdom::playTurnWith(ActionSource& source) {
+    if (!stepWith<D>(source.nextAction(*this)) && !gameOver) {
+        stepWith<D>(PlayerAction(ACTION_WAIT));
+    }
+}
+
+template void Kingdom::advanceTurn<EASY>();
+template void Kingdom::advanceTurn<MEDIUM>();
+template void Kingdom::advanceTurn<HARD>();
+template bool Kingdom::stepWith<EASY>(const PlayerAction&);
+template bool Kingdom::stepWith<MEDIUM>(const PlayerAction&);
+template bool Kingdom::stepWith<HARD>(const PlayerAction&);
+template void Kingdom::playTurnWith<EASY>(ActionSource&);
+template void Kingdom::playTurnWith<MEDIUM>(ActionSource&);
+template void Kingdom::playTurnWith<HARD>(ActionSource&);
+template int Kingdom::advanceWith<EASY>(int);
+template int Kingdom::advanceWith<MEDIUM>(int);
+template int Kingdom::advanceWith<HARD>(int);
+
+void Kingdom::saveGame() const {
+    ofstream saveFile("stronghold_save.txt");
+    saveFile << turn << "\n";
+    saveFile << static_cast<int>(difficulty) << "\n";
+    saveFile << currentKing.name << "\n";
+    saveFile << currentKing.taxRate << "\n";
+    saveFile << food.get() << "\n";
+    saveFile << gold.get() << "\n";
+    saveFile << wood.get() << "\n";
+    saveFile << stone.get() << "\n";
+    saveFile << iron.get() << "\n";
+    saveFile << weapons.get() << "\n";
+    saveFile << population.getHappiness() << "\n";
+    saveFile << population.getPeasants() << "\n";
+    saveFile << population.getTotal() << "\n";
+    saveFile.close();
+    narrator() << "Game saved.\n";
+}
+
+void Kingdom::loadGame() {
+    ifstream saveFile("stronghold_save.txt");
+    if (saveFile) {
+        int diff;
+        string kingName;
+        int taxRate, f, g, w, s, i, wp, happiness, peasants, totalPop;
+        saveFile >> turn;
+        saveFile >> diff;
+        difficulty = isDifficulty(diff) ? static_cast<Difficulty>(diff) : MEDIUM;
+        saveFile.ignore();
+        getline(saveFile, kingName);
+        saveFile >> taxRate;
+        saveFile >> f >> g >> w >> s >> i >> wp >> happiness >> peasants >> totalPop;
+        currentKing = King(kingName);
+        currentKing.setTaxRate(taxRate);
+        int merchants = totalPop * 0.2;  // Adjust these ratios as needed
+        int nobility = totalPop * 0.1;
+        int soldiers = totalPop - peasants - merchants - nobility;
+
+        population = Population(peasants, merchants, nobility, soldiers, happiness);
+        food.set(f);
+        gold.set(g);
+        wood.set(w);
+        stone.set(s);
+        iron.set(i);
+        weapons.set(wp);
+
+        narrator() << "Game loaded.\n";
+    }
+    else {
+        narrator() << "No save file found.\n";
+    }
+}
+
+bool Kingdom::saveBinary(const string& path) const {
+    KingdomArchiveWriter writer(path);
+    if (!writer.isOpen()) {
+        narrator() << "Could not write " << path << "\n";
+        return false;
+    }
+    writer.add(*this);
+    if (!writer.close()) {
+        narrator() << "Could not write " << path << "\n";
+        return false;
+    }
+    narrator() << "Game saved.\n";
+    return true;
+}
+
+bool Kingdom::loadBinary(const string& path) {
+    MappedKingdomArchive archive;
+    if (!archive.open(path) || archive.size() == 0) {
+        narrator() << "No valid save file found.\n";
+        return false;
+    }
+    if (!archive[0].restore(*this)) {
+        narrator() << "Save file is corrupt.\n";
+        return false;
+    }
+    narrator() << "Game loaded.\n";
+    return true;
+}
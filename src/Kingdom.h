@@ -0,0 +1,189 @@
+#pragma once
+#include "GameTypes.h"
+#include "Narrator.h"
+#include "Random.h"
+#include "Leader.h"
+#include "Inventory.h"
+#include "Population.h"
+#include "Army.h"
+#include "Bank.h"
+#include "Market.h"
+#include "BuildingSystem.h"
+#include "ActionLog.h"
+#include "EventTable.h"
+#include "DifficultyRules.h"
+#include <type_traits>
+
+class ActionSource;
+class StatusRenderer;
+
+// All state is held by value, so copying a Kingdom is a plain memcpy with no
+// heap allocation; search and rollback code forks it freely (see fork()).
+class Kingdom {
+public:
+    int turn;
+    Difficulty difficulty;
+    King currentKing;
+    Population population;
+    Army army;
+    Bank bank;
+    Market market;
+    BuildingSystem buildings;
+    Inventory<int> food;
+    Inventory<int> gold;
+    Inventory<int> wood;
+    Inventory<int> stone;
+    Inventory<int> iron;
+    Inventory<int> weapons;
+    int lastDisasterTurn;
+    int lastWarTurn;
+    int lastElectionTurn;
+    int lastEvent;          // random event fired by the latest step, -1 if none
+    bool gameOver;
+    GameOutcome outcome;
+    bool saveRequested;     // the player quit choosing to save
+    Random rng;
+    ActionLog* recorder;
+    const EventTable* events;
+    const BalanceParams* balance;
+
+    void randomEvent();
+    void checkElection();
+    // Ends the game on a loss or a win; narrates it but draws no status, so
+    // the caller renders the final frame
+    void checkGameOver();
+
+public:
+    Kingdom(Difficulty diff, uint64_t seed = 1);
+
+    // Copy for speculative play: identical state, but not recording
+    Kingdom fork() const {
+        Kingdom copy(*this);
+        copy.recorder = nullptr;
+        return copy;
+    }
+
+    void showStatus() const;
+
+    // Food consumption, soldier pay, production and loan installments.
+    // KingdomBatch::advanceEconomy must stay bit-for-bit identical to this.
+    void economyPhase();
+    void nextTurn();
+
+    // nextTurn, step and playTurn with the rule set fixed at compile time.
+    // D must equal difficulty; the untemplated versions dispatch on it.
+    template <Difficulty D> void advanceTurn();
+    template <Difficulty D> bool stepWith(const PlayerAction& action);
+    template <Difficulty D> void playTurnWith(ActionSource& source);
+
+    // Same as calling nextTurn() `turns` times; returns the turns played,
+    // fewer if the game ends
+    int advance(int turns);
+    template <Difficulty D> int advanceWith(int turns);
+
+    // Applies one player action. Returns false when the action does not end
+    // the turn (quitting or an unknown choice).
+    bool performAction(const PlayerAction& action);
+
+    // Performs the action and, if it used up the turn, advances the kingdom.
+    bool step(const PlayerAction& action);
+    void playerTurn(ActionSource& source);
+    void playerTurn();
+
+    // Interactive turn that redraws only what changed on the status panel
+    void playerTurn(ActionSource& source, StatusRenderer& display);
+
+    // Headless game loop: no status screens, and a rejected action simply
+    // passes the turn so a script can never stall the game.
+    void play(ActionSource& source);
+
+    // One turn of play()
+    void playTurn(ActionSource& source);
+
+    // Zobrist hash of the game position: turn, stocks, population cohorts,
+    // buildings, army, bank, market prices, tax rate and the event timers.
+    // The random stream is left out, since search reseeds it, and so are the
+    // rules behind the pointers (BalanceParams, EventTable): positions of
+    // games played under different rules must not share a hash table.
+    // Stocks, buildings and class counts update their part as they change.
+    uint64_t hash() const;
+
+    // The inventory a commodity is stored in
+    Inventory<int>& stock(Commodity commodity);
+    const Inventory<int>& stock(Commodity commodity) const;
+
+    bool isGameOver() const {
+        return gameOver;
+    }
+
+    // Plays by the given balance constants from now on; params must outlive
+    // the kingdom and any forks of it
+    void useBalance(const BalanceParams* params) {
+        balance = params;
+    }
+
+    const BalanceParams& getBalance() const {
+        return *balance;
+    }
+
+    // Every action passed to step is appended to log (nullptr stops recording)
+    void record(ActionLog* log) {
+        recorder = log;
+    }
+
+    GameOutcome getOutcome() const {
+        return outcome;
+    }
+
+    // True once the player quit with "save". performAction only records the
+    // choice, since it also runs on server workers and in replays; the
+    // interactive loop calls saveGame().
+    bool wantsSave() const {
+        return saveRequested;
+    }
+
+    void saveGame() const;
+    void loadGame();
+
+    // Full-state binary save; see KingdomRecord
+    bool saveBinary(const string& path) const;
+    bool loadBinary(const string& path);
+};
+
+static_assert(is_trivially_copyable<Kingdom>::value, "Kingdom must stay trivially copyable");
+
+// A kingdom whose difficulty is part of its type. Its turn methods call the
+// instantiations for D directly, so headless loops that know the difficulty
+// up front (see dispatchDifficulty) run branch-free turn code. It is still a
+// Kingdom and can be passed, copied or saved as one.
+template <Difficulty D>
+class RuledKingdom : public Kingdom {
+public:
+    explicit RuledKingdom(uint64_t seed = 1) : Kingdom(D, seed) {}
+
+    void nextTurn() {
+        advanceTurn<D>();
+    }
+
+    int advance(int turns) {
+        return advanceWith<D>(turns);
+    }
+
+    bool step(const PlayerAction& action) {
+        return stepWith<D>(action);
+    }
+
+    void playTurn(ActionSource& source) {
+        playTurnWith<D>(source);
+    }
+
+    void play(ActionSource& source) {
+        while (!gameOver) {
+            playTurnWith<D>(source);
+        }
+    }
+};
+
+typedef RuledKingdom<EASY> EasyKingdom;
+typedef RuledKingdom<MEDIUM> MediumKingdom;
+typedef RuledKingdom<HARD> HardKingdom;
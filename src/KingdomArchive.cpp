@@ -0,0 +1,99 @@
+#include "KingdomArchive.h"
+#include "Kingdom.h"
+#include <cstring>
+#include <cstddef>
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char ARCHIVE_MAGIC[8] = { 'S', 'H', 'K', 'D', 'A', 'R', 'C', '1' };
+
+ArchiveHeader ArchiveHeader::make(uint64_t records) {
+    ArchiveHeader header;
+    memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = KINGDOM_RECORD_VERSION;
+    header.recordSize = sizeof(KingdomRecord);
+    header.count = records;
+    return header;
+}
+
+KingdomArchiveWriter::KingdomArchiveWriter(const string& path) : file(path, ios::binary | ios::trunc), count(0) {
+    ArchiveHeader header = ArchiveHeader::make(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void KingdomArchiveWriter::add(const KingdomRecord& record) {
+    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    count++;
+}
+
+void KingdomArchiveWriter::add(const Kingdom& kingdom) {
+    add(KingdomRecord::capture(kingdom));
+}
+
+void KingdomArchiveWriter::addAll(const KingdomRecord* records, size_t n) {
+    file.write(reinterpret_cast<const char*>(records), n * sizeof(KingdomRecord));
+    count += n;
+}
+
+bool KingdomArchiveWriter::close() {
+    if (!file.is_open()) return false;
+    file.seekp(offsetof(ArchiveHeader, count));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    bool ok = file.good();
+    file.close();
+    return ok;
+}
+
+void MappedKingdomArchive::unmap() {
+#ifndef _WIN32
+    if (data) munmap(const_cast<char*>(data), length);
+#endif
+    data = nullptr;
+    length = 0;
+    count = 0;
+}
+
+bool MappedKingdomArchive::open(const string& path) {
+    unmap();
+#ifdef _WIN32
+    ifstream file(path, ios::binary);
+    if (!file) return false;
+    buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    data = buffer.data();
+    length = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ArchiveHeader))) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mapped);
+    length = info.st_size;
+#endif
+    if (length < sizeof(ArchiveHeader)) {
+        unmap();
+        return false;
+    }
+    const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(data);
+    if (memcmp(header->magic, ARCHIVE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != KINGDOM_RECORD_VERSION ||
+        header->recordSize != sizeof(KingdomRecord) ||
+        header->count > (length - sizeof(ArchiveHeader)) / sizeof(KingdomRecord)) {
+        unmap();
+        return false;
+    }
+    count = header->count;
+    return true;
+}
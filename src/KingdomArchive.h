@@ -0,0 +1,78 @@
+#pragma once
+#include "GameTypes.h"
+#include "KingdomRecord.h"
+
+// Header at the start of every binary save / archive file, followed by
+// `count` KingdomRecords back to back.
+struct ArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t count;
+
+    // A header for `records` records of the current version
+    static ArchiveHeader make(uint64_t records);
+};
+
+// Streams kingdoms into an archive file. The record count in the header is
+// filled in by close().
+class KingdomArchiveWriter {
+private:
+    ofstream file;
+    uint64_t count;
+public:
+    explicit KingdomArchiveWriter(const string& path);
+
+    ~KingdomArchiveWriter() {
+        close();
+    }
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    void add(const KingdomRecord& record);
+    void add(const Kingdom& kingdom);
+    void addAll(const KingdomRecord* records, size_t n);
+    bool close();
+};
+
+// Read-only view of an archive file. On POSIX systems the file is mapped
+// into memory and records are accessed in place, without parsing or copying.
+class MappedKingdomArchive {
+private:
+    const char* data;
+    size_t length;
+    uint64_t count;
+#ifdef _WIN32
+    vector<char> buffer;
+#endif
+
+    void unmap();
+
+public:
+    MappedKingdomArchive() : data(nullptr), length(0), count(0) {}
+
+    ~MappedKingdomArchive() {
+        unmap();
+    }
+
+    MappedKingdomArchive(const MappedKingdomArchive&) = delete;
+    MappedKingdomArchive& operator=(const MappedKingdomArchive&) = delete;
+
+    // Fails on a foreign or truncated file. Records are checked only when
+    // restored, so opening does not touch the mapped pages.
+    bool open(const string& path);
+
+    size_t size() const {
+        return static_cast<size_t>(count);
+    }
+
+    const KingdomRecord* records() const {
+        return reinterpret_cast<const KingdomRecord*>(data + sizeof(ArchiveHeader));
+    }
+
+    const KingdomRecord& operator[](size_t i) const {
+        return records()[i];
+    }
+};
@@ -0,0 +1,207 @@
+#include "KingdomBatch.h"
+#include "Kingdom.h"
+#include "Random.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+void KingdomBatch::advanceScalar(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        int32_t consumption = (peasants[i] + merchants[i] + nobility[i] + popSoldiers[i]) / 2;
+        if (consumption <= food[i]) food[i] -= consumption;
+
+        int32_t pay = armySoldiers[i] * balance.soldierPay;
+        if (gold[i] >= pay) {
+            gold[i] -= pay;
+            morale[i] += 5;
+        }
+
+        food[i] += farms[i] * balance.farmYield;
+        iron[i] += mines[i] * balance.mineYield;
+    }
+}
+
+// Handles the largest multiple of 8 kingdoms and returns how many it did
+size_t KingdomBatch::advanceAvx2(size_t count) {
+#ifdef __AVX2__
+    const __m256i farmYield = _mm256_set1_epi32(balance.farmYield);
+    const __m256i mineYield = _mm256_set1_epi32(balance.mineYield);
+    const __m256i soldierPay = _mm256_set1_epi32(balance.soldierPay);
+    const __m256i moraleBoost = _mm256_set1_epi32(5);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&food[i]));
+        __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&gold[i]));
+        __m256i ir = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&iron[i]));
+        __m256i mo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&morale[i]));
+
+        __m256i total = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&peasants[i])),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&merchants[i]))),
+            _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&nobility[i])),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&popSoldiers[i]))));
+        // total / 2 rounding toward zero, as in C++ integer division
+        __m256i consumption = _mm256_srai_epi32(_mm256_add_epi32(total, _mm256_srli_epi32(total, 31)), 1);
+        __m256i shortFood = _mm256_cmpgt_epi32(consumption, f);
+        f = _mm256_blendv_epi8(_mm256_sub_epi32(f, consumption), f, shortFood);
+
+        __m256i soldiers = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&armySoldiers[i]));
+        __m256i pay = _mm256_mullo_epi32(soldiers, soldierPay);
+        __m256i shortGold = _mm256_cmpgt_epi32(pay, g);
+        g = _mm256_blendv_epi8(_mm256_sub_epi32(g, pay), g, shortGold);
+        mo = _mm256_add_epi32(mo, _mm256_andnot_si256(shortGold, moraleBoost));
+
+        __m256i fa = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&farms[i]));
+        __m256i mi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&mines[i]));
+        f = _mm256_add_epi32(f, _mm256_mullo_epi32(fa, farmYield));
+        ir = _mm256_add_epi32(ir, _mm256_mullo_epi32(mi, mineYield));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&food[i]), f);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&gold[i]), g);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&iron[i]), ir);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&morale[i]), mo);
+    }
+    return i;
+#else
+    (void)count;
+    return 0;
+#endif
+}
+
+// Collects each kingdom's installment worked out by LoanLedger::accrue, as
+// Bank::collectInstallments does
+void KingdomBatch::settleLoans() {
+    for (size_t i = 0; i < size(); i++) {
+        int amount = installment[i];
+        if (amount == 0) continue;
+        size_t slots = i * MAX_LOANS;
+        bool paid = gold[i] >= amount;
+        if (paid) {
+            gold[i] -= amount;
+            bankReserve[i] += amount;
+            bankTrust[i] += 0.05f;
+            if (bankTrust[i] > 1.0f) bankTrust[i] = 1.0f;
+        }
+        else {
+            bankTrust[i] -= 0.1f;
+            if (bankTrust[i] < 0.0f) bankTrust[i] = 0.0f;
+        }
+        LoanLedger::settle(&loanBalance[slots], &loanPayment[slots], &loanTurns[slots], paid);
+    }
+}
+
+bool KingdomBatch::isVectorized() {
+#ifdef __AVX2__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void KingdomBatch::resize(size_t count) {
+    turn.resize(count);
+    food.resize(count);
+    gold.resize(count);
+    iron.resize(count);
+    peasants.resize(count);
+    merchants.resize(count);
+    nobility.resize(count);
+    popSoldiers.resize(count);
+    armySoldiers.resize(count);
+    morale.resize(count);
+    farms.resize(count);
+    mines.resize(count);
+    foodPrice.resize(count);
+    weaponPrice.resize(count);
+    bankReserve.resize(count);
+    bankTrust.resize(count);
+    loanBalance.resize(count * MAX_LOANS);
+    loanRate.resize(count * MAX_LOANS);
+    loanPayment.resize(count * MAX_LOANS);
+    loanTurns.resize(count * MAX_LOANS);
+    installment.resize(count);
+    seed.resize(count);
+    draws.resize(count);
+}
+
+void KingdomBatch::load(size_t i, const Kingdom& kingdom) {
+    turn[i] = kingdom.turn;
+    food[i] = kingdom.food.get();
+    gold[i] = kingdom.gold.get();
+    iron[i] = kingdom.iron.get();
+    peasants[i] = kingdom.population.getPeasants();
+    merchants[i] = kingdom.population.getMerchants();
+    nobility[i] = kingdom.population.getNobility();
+    popSoldiers[i] = kingdom.population.getSoldiers();
+    armySoldiers[i] = kingdom.army.getSoldiers();
+    morale[i] = kingdom.army.getMorale();
+    farms[i] = kingdom.buildings.getFarms();
+    mines[i] = kingdom.buildings.getMines();
+    foodPrice[i] = kingdom.market.getFoodPrice();
+    weaponPrice[i] = kingdom.market.getWeaponPrice();
+    seed[i] = kingdom.rng.getSeed();
+    bankReserve[i] = kingdom.bank.goldReserve;
+    bankTrust[i] = kingdom.bank.trustRate;
+    const LoanLedger& loans = kingdom.bank.loans;
+    copy(loans.balance, loans.balance + MAX_LOANS, &loanBalance[i * MAX_LOANS]);
+    copy(loans.rate, loans.rate + MAX_LOANS, &loanRate[i * MAX_LOANS]);
+    copy(loans.payment, loans.payment + MAX_LOANS, &loanPayment[i * MAX_LOANS]);
+    copy(loans.turnsLeft, loans.turnsLeft + MAX_LOANS, &loanTurns[i * MAX_LOANS]);
+}
+
+void KingdomBatch::store(size_t i, Kingdom& kingdom) const {
+    kingdom.turn = turn[i];
+    kingdom.food.set(food[i]);
+    kingdom.gold.set(gold[i]);
+    kingdom.iron.set(iron[i]);
+    kingdom.army.setMorale(morale[i]);
+    kingdom.market.setPrices(foodPrice[i], weaponPrice[i]);
+    kingdom.bank.goldReserve = bankReserve[i];
+    kingdom.bank.trustRate = bankTrust[i];
+    LoanLedger& loans = kingdom.bank.loans;
+    copy(&loanBalance[i * MAX_LOANS], &loanBalance[(i + 1) * MAX_LOANS], loans.balance);
+    copy(&loanTurns[i * MAX_LOANS], &loanTurns[(i + 1) * MAX_LOANS], loans.turnsLeft);
+}
+
+void KingdomBatch::advanceEconomy() {
+    size_t count = size();
+    size_t done = advanceAvx2(count);
+    advanceScalar(done, count);
+    LoanLedger::accrue(loanBalance.data(), loanRate.data(), loanPayment.data(), installment.data(), count);
+    settleLoans();
+    for (size_t i = 0; i < count; i++) turn[i]++;
+}
+
+void KingdomBatch::advanceMarket() {
+    size_t count = size();
+    Random::fillLanes(seed.data(), turn.data(), Random::STREAM_MARKET, 0, draws.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        foodPrice[i] += Random::bounded(draws[i], 3) - 1;
+    }
+    Random::fillLanes(seed.data(), turn.data(), Random::STREAM_MARKET, 1, draws.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        weaponPrice[i] += Random::bounded(draws[i], 5) - 2;
+    }
+    size_t done = 0;
+#ifdef __AVX2__
+    const __m256i minFood = _mm256_set1_epi32(1);
+    const __m256i minWeapon = _mm256_set1_epi32(3);
+    for (; done + 8 <= count; done += 8) {
+        __m256i fp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&foodPrice[done]));
+        __m256i wp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&weaponPrice[done]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&foodPrice[done]), _mm256_max_epi32(fp, minFood));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&weaponPrice[done]), _mm256_max_epi32(wp, minWeapon));
+    }
+#endif
+    for (size_t i = done; i < count; i++) {
+        if (foodPrice[i] < 1) foodPrice[i] = 1;
+        if (weaponPrice[i] < 3) weaponPrice[i] = 3;
+    }
+}
+
+void KingdomBatch::advanceEconomyScalar() {
+    advanceScalar(0, size());
+    LoanLedger::accrueScalar(loanBalance.data(), loanRate.data(), loanPayment.data(), installment.data(), size());
+    settleLoans();
+    for (size_t i = 0; i < size(); i++) turn[i]++;
+}
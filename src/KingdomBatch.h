@@ -0,0 +1,92 @@
+#pragma once
+#include "GameTypes.h"
+#include "BalanceParams.h"
+
+class Kingdom;
+
+// Structure-of-arrays copy of the per-turn economy of many kingdoms. Each
+// field is one contiguous array indexed by kingdom, so advanceEconomy can run
+// Kingdom::economyPhase for 8 kingdoms per AVX2 instruction, and
+// advanceMarket replays Market::updatePrices. Loans are stored the same way,
+// MAX_LOANS slots per kingdom back to back, so interest on every loan in the
+// batch accrues in one vectorized pass. It is headless: nothing is
+// narrated. Demography, events, elections and game-over checks still run
+// through Kingdom. Every kingdom in a batch plays by the same BalanceParams.
+class KingdomBatch {
+private:
+    vector<int32_t> turn;
+    vector<int32_t> food;
+    vector<int32_t> gold;
+    vector<int32_t> iron;
+    vector<int32_t> peasants;
+    vector<int32_t> merchants;
+    vector<int32_t> nobility;
+    vector<int32_t> popSoldiers;
+    vector<int32_t> armySoldiers;
+    vector<int32_t> morale;
+    vector<int32_t> farms;
+    vector<int32_t> mines;
+    vector<int32_t> foodPrice;
+    vector<int32_t> weaponPrice;
+    vector<int32_t> bankReserve;
+    vector<float> bankTrust;
+    vector<float> loanBalance;      // kingdom i, slot s at i * MAX_LOANS + s
+    vector<float> loanRate;
+    vector<float> loanPayment;
+    vector<int32_t> loanTurns;
+    vector<int32_t> installment;    // per kingdom, this turn's total due
+    vector<uint64_t> seed;
+    vector<uint64_t> draws;
+    BalanceParams balance;
+
+    void advanceScalar(size_t begin, size_t end);
+    size_t advanceAvx2(size_t count);
+    void settleLoans();
+
+public:
+    explicit KingdomBatch(size_t count = 0) {
+        resize(count);
+    }
+
+    void resize(size_t count);
+
+    size_t size() const {
+        return food.size();
+    }
+
+    // Balance constants for the whole batch; standard unless set
+    void setBalance(const BalanceParams& params) {
+        balance = params;
+    }
+
+    // True when the library was built with AVX2 enabled
+    static bool isVectorized();
+
+    // Copies the economy of a kingdom into slot i
+    void load(size_t i, const Kingdom& kingdom);
+
+    // Writes the fields the economy phase changes back into a kingdom
+    void store(size_t i, Kingdom& kingdom) const;
+
+    int getTurn(size_t i) const { return turn[i]; }
+    int getFood(size_t i) const { return food[i]; }
+    int getGold(size_t i) const { return gold[i]; }
+    int getIron(size_t i) const { return iron[i]; }
+    int getMorale(size_t i) const { return morale[i]; }
+    int getFoodPrice(size_t i) const { return foodPrice[i]; }
+    int getWeaponPrice(size_t i) const { return weaponPrice[i]; }
+    int getBankReserve(size_t i) const { return bankReserve[i]; }
+    float getBankTrust(size_t i) const { return bankTrust[i]; }
+
+    // One turn of Kingdom::economyPhase for every kingdom in the batch
+    void advanceEconomy();
+
+    // Market::updatePrices for every kingdom at its current turn. The drift
+    // comes from the market stream of each kingdom's Random, so it matches
+    // the scalar path no matter what else was drawn that turn.
+    void advanceMarket();
+
+    // Same update without SIMD; tests/economy_kernel_test.cpp checks both
+    // against Kingdom::economyPhase
+    void advanceEconomyScalar();
+};
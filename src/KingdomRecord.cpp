@@ -0,0 +1,138 @@
+#include "KingdomRecord.h"
+#include "Kingdom.h"
+#include <cstring>
+
+static_assert(RECORD_COHORT_COUNT == COHORT_COUNT, "record must hold every population cohort");
+static_assert(RECORD_LOAN_COUNT == MAX_LOANS, "record must hold every loan slot");
+
+// A Name is always zero-padded to its full length, so it is copied whole
+void KingdomRecord::copyName(char* dest, const Name& src) {
+    memcpy(dest, src.c_str(), RECORD_NAME_LENGTH);
+}
+
+Name KingdomRecord::readName(const char* src) {
+    return Name(src, strnlen(src, RECORD_NAME_LENGTH));
+}
+
+KingdomRecord KingdomRecord::capture(const Kingdom& kingdom) {
+    KingdomRecord r;
+    r.rngSeed = kingdom.rng.getSeed();
+    r.rngTurn = kingdom.rng.getTurn();
+    r.rngCounter = kingdom.rng.getCounter();
+
+    r.turn = kingdom.turn;
+    r.difficulty = kingdom.difficulty;
+    r.gameOver = kingdom.gameOver;
+    r.outcome = kingdom.outcome;
+    r.lastDisasterTurn = kingdom.lastDisasterTurn;
+    r.lastWarTurn = kingdom.lastWarTurn;
+    r.lastElectionTurn = kingdom.lastElectionTurn;
+
+    r.kingLeadership = kingdom.currentKing.leadership;
+    r.kingCorruption = kingdom.currentKing.corruption;
+    r.kingTaxRate = kingdom.currentKing.taxRate;
+    copyName(r.kingName, kingdom.currentKing.name);
+    copyName(r.kingCommander, kingdom.currentKing.Commander);
+
+    r.food = kingdom.food.get();
+    r.gold = kingdom.gold.get();
+    r.wood = kingdom.wood.get();
+    r.stone = kingdom.stone.get();
+    r.iron = kingdom.iron.get();
+    r.weapons = kingdom.weapons.get();
+
+    const Population& pop = kingdom.population;
+    memcpy(r.cohorts, pop.cohorts, sizeof(r.cohorts));
+    r.happiness = pop.happiness;
+
+    r.armySoldiers = kingdom.army.soldiers;
+    r.armyWeapons = kingdom.army.weapons;
+    r.armyMorale = kingdom.army.morale;
+    r.armyInWar = kingdom.army.inWar;
+
+    r.bankReserve = kingdom.bank.goldReserve;
+    r.bankTrust = kingdom.bank.trustRate;
+    const LoanLedger& loans = kingdom.bank.loans;
+    memcpy(r.loanBalance, loans.balance, sizeof(r.loanBalance));
+    memcpy(r.loanRate, loans.rate, sizeof(r.loanRate));
+    memcpy(r.loanPayment, loans.payment, sizeof(r.loanPayment));
+    memcpy(r.loanTurnsLeft, loans.turnsLeft, sizeof(r.loanTurnsLeft));
+
+    const Market& market = kingdom.market;
+    r.foodPrice = market.foodPrice;
+    r.weaponPrice = market.weaponPrice;
+    r.routeCount = market.routeCount;
+    for (int i = 0; i < RECORD_ROUTE_COUNT; i++) {
+        // unused route slots are never initialized by Market
+        bool used = i < market.routeCount;
+        r.routeValues[i] = used ? market.tradeRoutes[i].value : 0;
+        copyName(r.routeNames[i], used ? market.tradeRoutes[i].name : Name());
+    }
+
+    r.farms = kingdom.buildings.farms;
+    r.barracks = kingdom.buildings.barracks;
+    r.mines = kingdom.buildings.mines;
+    r.blacksmiths = kingdom.buildings.blacksmiths;
+    r.reserved = 0;
+    return r;
+}
+
+bool KingdomRecord::restore(Kingdom& kingdom) const {
+    if (!isValid()) return false;
+    kingdom.rng.seed(rngSeed);
+    kingdom.rng.seek(rngTurn, rngCounter);
+
+    kingdom.turn = turn;
+    kingdom.difficulty = static_cast<Difficulty>(difficulty);
+    kingdom.gameOver = gameOver != 0;
+    kingdom.outcome = static_cast<GameOutcome>(outcome);
+    kingdom.saveRequested = false;
+    kingdom.lastDisasterTurn = lastDisasterTurn;
+    kingdom.lastWarTurn = lastWarTurn;
+    kingdom.lastElectionTurn = lastElectionTurn;
+
+    kingdom.currentKing = King(readName(kingName), kingLeadership, kingCorruption);
+    kingdom.currentKing.taxRate = kingTaxRate;
+    kingdom.currentKing.Commander = readName(kingCommander);
+
+    kingdom.food.set(food);
+    kingdom.gold.set(gold);
+    kingdom.wood.set(wood);
+    kingdom.stone.set(stone);
+    kingdom.iron.set(iron);
+    kingdom.weapons.set(weapons);
+
+    memcpy(kingdom.population.cohorts, cohorts, sizeof(cohorts));
+    kingdom.population.happiness = happiness;
+    kingdom.population.recount();
+    kingdom.population.rehash();
+
+    kingdom.army.soldiers = armySoldiers;
+    kingdom.army.weapons = armyWeapons;
+    kingdom.army.morale = armyMorale;
+    kingdom.army.inWar = armyInWar != 0;
+
+    kingdom.bank.goldReserve = bankReserve;
+    kingdom.bank.trustRate = bankTrust;
+    LoanLedger& loans = kingdom.bank.loans;
+    memcpy(loans.balance, loanBalance, sizeof(loanBalance));
+    memcpy(loans.rate, loanRate, sizeof(loanRate));
+    memcpy(loans.payment, loanPayment, sizeof(loanPayment));
+    memcpy(loans.turnsLeft, loanTurnsLeft, sizeof(loanTurnsLeft));
+
+    Market& market = kingdom.market;
+    market.foodPrice = foodPrice;
+    market.weaponPrice = weaponPrice;
+    market.routeCount = routeCount;
+    for (int i = 0; i < RECORD_ROUTE_COUNT; i++) {
+        market.tradeRoutes[i].value = routeValues[i];
+        market.tradeRoutes[i].name = readName(routeNames[i]);
+    }
+
+    kingdom.buildings.farms = farms;
+    kingdom.buildings.barracks = barracks;
+    kingdom.buildings.mines = mines;
+    kingdom.buildings.blacksmiths = blacksmiths;
+    kingdom.buildings.rehash();
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "GameTypes.h"
+#include "FixedName.h"
+
+class Kingdom;
+
+// Fixed-layout binary image of the complete state of one kingdom. Fields are
+// ordered widest first so there is no padding; integers are stored in host
+// (little-endian) byte order. Bump KINGDOM_RECORD_VERSION on any layout change.
+const uint32_t KINGDOM_RECORD_VERSION = 3;
+const int RECORD_NAME_LENGTH = 32;
+const int RECORD_ROUTE_COUNT = 5;
+const int RECORD_COHORT_COUNT = 16;
+const int RECORD_LOAN_COUNT = 8;
+
+struct KingdomRecord {
+    uint64_t rngSeed;
+    uint32_t rngTurn;
+    uint32_t rngCounter;
+
+    int32_t turn;
+    int32_t difficulty;
+    int32_t gameOver;
+    int32_t outcome;
+    int32_t lastDisasterTurn;
+    int32_t lastWarTurn;
+    int32_t lastElectionTurn;
+
+    int32_t kingLeadership;
+    int32_t kingCorruption;
+    int32_t kingTaxRate;
+
+    int32_t food, gold, wood, stone, iron, weapons;
+
+    int32_t happiness;
+    float cohorts[RECORD_COHORT_COUNT];
+
+    int32_t armySoldiers, armyWeapons, armyMorale, armyInWar;
+
+    int32_t bankReserve;
+    float bankTrust;
+    float loanBalance[RECORD_LOAN_COUNT];
+    float loanRate[RECORD_LOAN_COUNT];
+    float loanPayment[RECORD_LOAN_COUNT];
+    int32_t loanTurnsLeft[RECORD_LOAN_COUNT];
+
+    int32_t foodPrice, weaponPrice, routeCount;
+    int32_t routeValues[RECORD_ROUTE_COUNT];
+
+    int32_t farms, barracks, mines, blacksmiths;
+    int32_t reserved; // keeps the size a multiple of 8
+
+    char kingName[RECORD_NAME_LENGTH];
+    char kingCommander[RECORD_NAME_LENGTH];
+    char routeNames[RECORD_ROUTE_COUNT][RECORD_NAME_LENGTH];
+
+    static void copyName(char* dest, const Name& src);
+    static Name readName(const char* src);
+    static KingdomRecord capture(const Kingdom& kingdom);
+
+    // False if an enum or the route count is out of range, as in a corrupt
+    // or foreign file
+    bool isValid() const {
+        return isDifficulty(difficulty) && outcome >= OUTCOME_IN_PROGRESS &&
+            outcome < OUTCOME_COUNT && routeCount >= 0 && routeCount <= RECORD_ROUTE_COUNT;
+    }
+
+    // Leaves the kingdom untouched and returns false if the record is not valid
+    bool restore(Kingdom& kingdom) const;
+};
+
+static_assert(RECORD_NAME_LENGTH == NAME_LENGTH, "record names must hold any Name");
+static_assert(sizeof(KingdomRecord) == 16 + 4 * (36 + RECORD_COHORT_COUNT + 4 * RECORD_LOAN_COUNT) +
+    RECORD_NAME_LENGTH * (2 + RECORD_ROUTE_COUNT),
+    "KingdomRecord must not contain padding");
@@ -0,0 +1,53 @@
+#pragma once
+#include "Narrator.h"
+#include "FixedName.h"
+
+// Leaders are held by value inside Kingdom, which must stay trivially
+// copyable, so the hierarchy has no virtual functions; each kind of leader
+// simply provides its own makeDecision.
+class Leader {
+public:
+    Name name;
+    int leadership;
+    int corruption;
+    Leader(const Name& n, int l, int c) : name(n), leadership(l), corruption(c) {}
+};
+
+class King : public Leader {
+public:
+    int taxRate;
+    Name Commander;
+    King(const Name& n, int l = 50, int c = 10) : Leader(n, l, c), taxRate(15) {}
+    void makeDecision() {
+        narrator() << name << " makes a royal decree.\n";
+    }
+    void setTaxRate(int rate) {
+        if (rate < 5 || rate > 50) {
+            narrator() << "Tax rate must be between 5% and 50%\n";
+            return;
+        }
+        taxRate = rate;
+        narrator() << name << " set tax rate to " << taxRate << "%.\n";
+    }
+    void appointCommander(const Name& ComName) {
+        Commander = ComName;
+        narrator() << name << " appointed " << Commander << " as commander.\n";
+    }
+};
+
+class Commander : public Leader {
+public:
+    int loyalty;
+    Commander(const Name& n, int l = 60, int c = 5) : Leader(n, l, c), loyalty(70) {}
+    void makeDecision() {
+        narrator() << name << " gives military orders.\n";
+    }
+};
+
+class MerchantLeader : public Leader {
+public:
+    MerchantLeader(const Name& n, int l = 40, int c = 30) : Leader(n, l, c) {}
+    void makeDecision() {
+        narrator() << name << " negotiates trade deals.\n";
+    }
+};
@@ -0,0 +1,256 @@
+#include "LoadClient.h"
+#include "ServerProtocol.h"
+#include "ActionSource.h"
+#include "Kingdom.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <queue>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+void LoadTestReport::print(ostream& out) const {
+    out << "Actions: " << actions << " in " << seconds << "s (" << (seconds > 0 ? actions / seconds : 0.0)
+        << "/s)  Games finished: " << gamesFinished << "  Late sends: " << late << "  Errors: " << errors << "\n";
+    out << "Latency us: p50 " << p50 << "  p99 " << p99 << "  p99.9 " << p999 << "  max " << worst << "\n";
+}
+
+static uint64_t nowNanos() {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// A TCP port on 127.0.0.1 if the address is all digits, else a socket path
+static int connectTo(const string& address) {
+    bool port = !address.empty() && address.find_first_not_of("0123456789") == string::npos;
+    int fd = socket(port ? AF_INET : AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int result;
+    if (port) {
+        sockaddr_in in = {};
+        in.sin_family = AF_INET;
+        in.sin_port = htons(static_cast<uint16_t>(atoi(address.c_str())));
+        in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        result = connect(fd, reinterpret_cast<sockaddr*>(&in), sizeof(in));
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    else {
+        sockaddr_un un = {};
+        if (address.size() >= sizeof(un.sun_path)) {
+            close(fd);
+            return -1;
+        }
+        un.sun_family = AF_UNIX;
+        memcpy(un.sun_path, address.c_str(), address.size() + 1);
+        result = connect(fd, reinterpret_cast<sockaddr*>(&un), sizeof(un));
+    }
+    if (result != 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+namespace {
+
+enum SlotState { SLOT_OPENING, SLOT_IDLE, SLOT_WAITING };
+
+// One simulated player
+struct Slot {
+    uint32_t session;
+    unsigned link;
+    SlotState state;
+    bool deferred;      // its send slot passed while it was waiting
+    uint64_t dueAt;     // when the action in flight (or deferred) was scheduled
+};
+
+struct Link {
+    int fd;
+    string in;
+    string out;
+
+    Link() : fd(-1) {}
+};
+
+}
+
+bool LoadClient::run(const LoadTestConfig& config, LoadTestReport& report) {
+    report = LoadTestReport();
+    unsigned linkCount = config.connections == 0 ? 1 : config.connections;
+    vector<Link> links(linkCount);
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    bool connected = epoll >= 0;
+    for (unsigned l = 0; l < linkCount && connected; l++) {
+        links[l].fd = connectTo(config.address);
+        if (links[l].fd < 0) {
+            connected = false;
+            break;
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u32 = l;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, links[l].fd, &event);
+    }
+    if (!connected) {
+        for (unsigned l = 0; l < linkCount; l++) {
+            if (links[l].fd >= 0) close(links[l].fd);
+        }
+        if (epoll >= 0) close(epoll);
+        return false;
+    }
+
+    // randomPolicy draws the action without looking at the kingdom
+    const Kingdom placeholder(MEDIUM);
+    Random rng(config.seed);
+    vector<Slot> slots(config.sessions);
+    for (uint32_t s = 0; s < slots.size(); s++) {
+        slots[s].link = s % linkCount;
+        slots[s].state = SLOT_OPENING;
+        slots[s].deferred = false;
+        putNewGame(links[slots[s].link].out, s, static_cast<Difficulty>(s % 3), Random::mixSeed(config.seed, s));
+    }
+
+    vector<uint64_t> latencies;
+    latencies.reserve(static_cast<size_t>(config.sessions * config.actionsPerSecond * config.seconds) + 1024);
+    size_t opening = slots.size();
+    bool timing = false;
+    bool failed = false;
+
+    // Latency runs from the scheduled time, not the actual send, so a send
+    // held back by a slow reply counts its wait too
+    auto send = [&](uint32_t s, uint64_t due) {
+        Slot& slot = slots[s];
+        putAction(links[slot.link].out, s, slot.session, randomPolicy(placeholder, rng));
+        slot.state = SLOT_WAITING;
+        slot.deferred = false;
+        slot.dueAt = due;
+    };
+
+    auto receive = [&](Link& link, uint64_t now) {
+        char buffer[65536];
+        ssize_t got = read(link.fd, buffer, sizeof(buffer));
+        if (got <= 0) {
+            if (got == 0 || (errno != EAGAIN && errno != EINTR)) failed = true;
+            return;
+        }
+        link.in.append(buffer, got);
+        size_t used = 0;
+        size_t size;
+        while ((size = frameSize(link.in.data() + used, link.in.size() - used)) > 0) {
+            ServerReply reply;
+            bool known = decodeReply(link.in.data() + used, reply) && reply.tag < slots.size();
+            used += size;
+            if (!known || reply.type == MSG_ERROR) {
+                report.errors++;
+                if (known && slots[reply.tag].state == SLOT_WAITING) slots[reply.tag].state = SLOT_IDLE;
+                continue;
+            }
+            Slot& slot = slots[reply.tag];
+            if (slot.state == SLOT_OPENING) {
+                slot.session = reply.session;
+                opening--;
+            }
+            else if (timing) {
+                latencies.push_back(now - slot.dueAt);
+                report.actions++;
+            }
+            slot.state = SLOT_IDLE;
+            if (reply.flags & STATUS_GAME_OVER) {
+                // Start over in a fresh game
+                report.gamesFinished++;
+                putEndGame(link.out, reply.tag, slot.session);
+                putNewGame(link.out, reply.tag, static_cast<Difficulty>(reply.tag % 3),
+                    Random::mixSeed(config.seed, reply.tag + slots.size() * report.gamesFinished));
+                slot.state = SLOT_OPENING;
+                opening++;
+            }
+            else if (slot.deferred) {
+                send(reply.tag, slot.dueAt);
+            }
+        }
+        link.in.erase(0, used);
+    };
+
+    // Writes what is queued, then waits up to timeout ms for replies
+    epoll_event events[64];
+    auto pump = [&](int timeout) {
+        bool backlog = false;
+        for (unsigned l = 0; l < linkCount; l++) {
+            Link& link = links[l];
+            if (link.out.empty()) continue;
+            ssize_t sent = write(link.fd, link.out.data(), link.out.size());
+            if (sent < 0 && errno != EAGAIN && errno != EINTR) failed = true;
+            if (sent > 0) link.out.erase(0, sent);
+            backlog = backlog || !link.out.empty();
+        }
+        int count = epoll_wait(epoll, events, 64, backlog ? 0 : timeout);
+        uint64_t now = nowNanos();
+        for (int e = 0; e < count; e++) receive(links[events[e].data.u32], now);
+    };
+
+    // Open every game before the clock starts
+    uint64_t giveUp = nowNanos() + 30000000000ull;
+    while (opening > 0 && !failed && nowNanos() < giveUp) pump(10);
+    failed = failed || opening > 0;
+
+    uint64_t interval = static_cast<uint64_t>(1e9 / (config.actionsPerSecond > 0 ? config.actionsPerSecond : 1.0));
+    uint64_t start = nowNanos();
+    uint64_t end = start + static_cast<uint64_t>(config.seconds * 1e9);
+    timing = true;
+
+    // Send times, earliest first; session s starts s / sessions of an
+    // interval in, so the load is spread evenly
+    typedef pair<uint64_t, uint32_t> Due;
+    priority_queue<Due, vector<Due>, greater<Due>> schedule;
+    for (uint32_t s = 0; s < slots.size(); s++) {
+        schedule.push(Due(start + interval * s / slots.size(), s));
+    }
+
+    while (!failed) {
+        uint64_t now = nowNanos();
+        if (now >= end) break;
+        while (!schedule.empty() && schedule.top().first <= now) {
+            Due due = schedule.top();
+            schedule.pop();
+            schedule.push(Due(due.first + interval, due.second));
+            Slot& slot = slots[due.second];
+            if (slot.state == SLOT_IDLE) {
+                send(due.second, due.first);
+            }
+            else if (!slot.deferred) {
+                slot.deferred = true;
+                slot.dueAt = due.first;
+                report.late++;
+            }
+        }
+        uint64_t next = schedule.empty() ? end : schedule.top().first;
+        uint64_t wait = next > now ? next - now : 0;
+        pump(static_cast<int>((wait + 999999) / 1000000));
+    }
+    report.seconds = (nowNanos() - start) / 1e9;
+
+    for (unsigned l = 0; l < linkCount; l++) close(links[l].fd);
+    close(epoll);
+
+    if (!latencies.empty()) {
+        auto percentile = [&](double p) {
+            size_t index = static_cast<size_t>(p * (latencies.size() - 1));
+            nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+            return latencies[index] / 1000.0;
+        };
+        report.p50 = percentile(0.50);
+        report.p99 = percentile(0.99);
+        report.p999 = percentile(0.999);
+        report.worst = *max_element(latencies.begin(), latencies.end()) / 1000.0;
+    }
+    return !failed;
+}
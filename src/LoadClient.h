@@ -0,0 +1,42 @@
+#pragma once
+#include "GameTypes.h"
+
+struct LoadTestConfig {
+    string address;              // Unix socket path, or a TCP port on 127.0.0.1
+    unsigned connections;
+    unsigned sessions;           // games kept open, spread over the connections
+    double seconds;
+    double actionsPerSecond;     // per session
+    uint64_t seed;
+
+    LoadTestConfig() : connections(16), sessions(10000), seconds(10.0), actionsPerSecond(1.0), seed(1) {}
+};
+
+struct LoadTestReport {
+    uint64_t actions;       // replies received
+    uint64_t late;          // actions sent after their slot because the last reply was still out
+    uint64_t errors;
+    uint64_t gamesFinished;
+    double seconds;
+    double p50;             // action latency percentiles, microseconds
+    double p99;
+    double p999;
+    double worst;
+
+    LoadTestReport() : actions(0), late(0), errors(0), gamesFinished(0), seconds(0.0),
+        p50(0.0), p99(0.0), p999(0.0), worst(0.0) {}
+
+    void print(ostream& out) const;
+};
+
+// Stand-in for many players, for load-testing GameServer. Every session
+// sends a random menu action at a fixed rate (open loop, staggered across
+// sessions) and times each status reply from when its action was due, so
+// sends held back behind a slow reply still count the delay. A session whose
+// game ends starts a new one. One thread drives every connection with epoll.
+class LoadClient {
+public:
+    // Opens the sessions, runs for config.seconds and closes everything.
+    // Returns false if the server could not be reached.
+    static bool run(const LoadTestConfig& config, LoadTestReport& report);
+};
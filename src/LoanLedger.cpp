@@ -0,0 +1,100 @@
+#include "LoanLedger.h"
+#include <cmath>
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define LOAN_SIMD 1
+#endif
+
+static_assert(MAX_LOANS == 8, "accrue handles a ledger as two 4-wide halves");
+
+// A balance below this is rounding left over from the schedule
+static const float PAID_OFF = 0.5f;
+
+float LoanLedger::schedulePayment(float principal, float rate, int term) {
+    if (rate <= 0.0f) return ceil(principal / term);
+    float payment = principal * rate / (1.0f - pow(1.0f + rate, static_cast<float>(-term)));
+    return ceil(payment);
+}
+
+int LoanLedger::open(int principal, float interestRate, int term) {
+    for (int i = 0; i < MAX_LOANS; i++) {
+        if (balance[i] != 0.0f) continue;
+        balance[i] = static_cast<float>(principal);
+        rate[i] = interestRate;
+        payment[i] = schedulePayment(balance[i], interestRate, term);
+        turnsLeft[i] = term;
+        return i;
+    }
+    return -1;
+}
+
+// Installment of one loan: the scheduled payment, or the whole balance if
+// that is less
+static inline float dueOn(float balance, float payment) {
+    return payment < balance ? payment : balance;
+}
+
+// Rounds a kingdom's summed dues up to whole gold
+static inline int32_t wholeGold(float total) {
+    int32_t whole = static_cast<int32_t>(total);
+    return whole < total ? whole + 1 : whole;
+}
+
+void LoanLedger::accrue(float* balances, const float* rates, const float* payments, int32_t* installments,
+    size_t ledgers) {
+#ifdef LOAN_SIMD
+    // Each ledger is two 4-wide halves; the dues are summed across the halves
+    // first, then pairwise, which is also the order accrueScalar uses
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t k = 0; k < ledgers; k++) {
+        float* b = balances + k * MAX_LOANS;
+        const float* r = rates + k * MAX_LOANS;
+        const float* p = payments + k * MAX_LOANS;
+        __m128 lo = _mm_mul_ps(_mm_loadu_ps(b), _mm_add_ps(one, _mm_loadu_ps(r)));
+        __m128 hi = _mm_mul_ps(_mm_loadu_ps(b + 4), _mm_add_ps(one, _mm_loadu_ps(r + 4)));
+        _mm_storeu_ps(b, lo);
+        _mm_storeu_ps(b + 4, hi);
+        __m128 sum = _mm_add_ps(_mm_min_ps(_mm_loadu_ps(p), lo), _mm_min_ps(_mm_loadu_ps(p + 4), hi));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        installments[k] = wholeGold(_mm_cvtss_f32(sum));
+    }
+#else
+    accrueScalar(balances, rates, payments, installments, ledgers);
+#endif
+}
+
+void LoanLedger::accrueScalar(float* balances, const float* rates, const float* payments, int32_t* installments,
+    size_t ledgers) {
+    for (size_t k = 0; k < ledgers; k++) {
+        float* b = balances + k * MAX_LOANS;
+        const float* r = rates + k * MAX_LOANS;
+        const float* p = payments + k * MAX_LOANS;
+        float lanes[4];
+        for (int i = 0; i < 4; i++) {
+            b[i] = b[i] * (1.0f + r[i]);
+            b[i + 4] = b[i + 4] * (1.0f + r[i + 4]);
+            lanes[i] = dueOn(b[i], p[i]) + dueOn(b[i + 4], p[i + 4]);
+        }
+        installments[k] = wholeGold((lanes[0] + lanes[2]) + (lanes[1] + lanes[3]));
+    }
+}
+
+void LoanLedger::settle(float* balances, const float* payments, int32_t* turns, bool paid) {
+    for (int i = 0; i < MAX_LOANS; i++) {
+        if (balances[i] == 0.0f) continue;
+        turns[i]--;
+        if (!paid) continue;
+        balances[i] -= dueOn(balances[i], payments[i]);
+        if (balances[i] < PAID_OFF) {
+            balances[i] = 0.0f;
+            turns[i] = 0;
+        }
+    }
+}
+
+float LoanLedger::outstanding() const {
+    float total = 0.0f;
+    for (int i = 0; i < MAX_LOANS; i++) total += balance[i];
+    return total;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "GameTypes.h"
+
+const int MAX_LOANS = 8;
+const int MAX_LOAN_TERM = 20;
+
+// The outstanding loans of one kingdom, in structure-of-arrays form with a
+// fixed number of slots so a Kingdom stays trivially copyable. A slot with a
+// zero balance is free. Each loan is an annuity: a fixed installment per turn
+// that pays off principal plus interest over its term. Interest is added to
+// the balance every turn, so a missed installment makes the debt grow.
+struct LoanLedger {
+    float balance[MAX_LOANS];     // owed, including capitalized interest
+    float rate[MAX_LOANS];        // interest per turn
+    float payment[MAX_LOANS];     // scheduled installment per turn
+    int32_t turnsLeft[MAX_LOANS]; // installments left on schedule; negative when overdue
+
+    LoanLedger() {
+        for (int i = 0; i < MAX_LOANS; i++) {
+            balance[i] = 0.0f;
+            rate[i] = 0.0f;
+            payment[i] = 0.0f;
+            turnsLeft[i] = 0;
+        }
+    }
+
+    // Installment that repays principal at rate in term turns, rounded up to
+    // whole gold
+    static float schedulePayment(float principal, float rate, int term);
+
+    // Books a new loan; returns its slot, or -1 if every slot is taken
+    int open(int principal, float interestRate, int term);
+
+    // One turn of interest on `ledgers` ledgers' worth of slots stored back
+    // to back (MAX_LOANS per kingdom), and each kingdom's total installment
+    // due, rounded up to whole gold. Vectorized; KingdomBatch runs it over the
+    // loans of every kingdom in one call.
+    static void accrue(float* balances, const float* rates, const float* payments, int32_t* installments,
+        size_t ledgers);
+
+    // Same update without SIMD; used to check the vector kernel
+    static void accrueScalar(float* balances, const float* rates, const float* payments, int32_t* installments,
+        size_t ledgers);
+
+    // Ends the turn for the open loans of one kingdom: if the installments
+    // were paid they come off the balances, and paid-off loans are closed
+    static void settle(float* balances, const float* payments, int32_t* turns, bool paid);
+
+    float outstanding() const;
+
+    int activeCount() const {
+        int count = 0;
+        for (int i = 0; i < MAX_LOANS; i++) count += balance[i] != 0.0f;
+        return count;
+    }
+};
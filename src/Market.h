@@ -0,0 +1,96 @@
+#pragma once
+#include "Narrator.h"
+#include "Random.h"
+#include "Inventory.h"
+#include "FixedName.h"
+#include "BalanceParams.h"
+
+struct KingdomRecord;
+
+class Market {
+private:
+    struct TradeRoute {
+        Name name;
+        int value;
+    };
+    TradeRoute tradeRoutes[5]; // Fixed size instead of vector
+    int routeCount;
+    int foodPrice;
+    int weaponPrice;
+    friend struct KingdomRecord;
+public:
+    Market() : routeCount(1), foodPrice(1), weaponPrice(5) {
+        tradeRoutes[0] = { "Neighbor Kingdom", 50 };
+    }
+
+    // Moves `quantity` goods one way and `value` gold the other. Fails without
+    // changing anything if the paying side cannot cover it.
+    static bool settle(OrderSide side, int quantity, int value, Inventory<int>& goods, Inventory<int>& gold) {
+        if (side == SIDE_BUY) {
+            if (gold.get() < value) return false;
+            gold.remove(value);
+            goods.add(quantity);
+        }
+        else {
+            if (goods.get() < quantity) return false;
+            goods.remove(quantity);
+            gold.add(value);
+        }
+        return true;
+    }
+
+    // Trading with the merchants: immediate fills at the quoted price
+    void buyFood(int amount, Inventory<int>& food, Inventory<int>& gold) {
+        int cost = amount * foodPrice;
+        if (!settle(SIDE_BUY, amount, cost, food, gold)) {
+            narrator() << "Not enough gold\n";
+            return;
+        }
+        narrator() << "Bought " << amount << " food for " << cost << " gold.\n";
+    }
+
+    // Merchants pay balance.sellRatio of the buy price
+    void sellFood(int amount, Inventory<int>& food, Inventory<int>& gold, const BalanceParams& balance) {
+        if (!settle(SIDE_SELL, amount, amount * foodPrice * balance.sellRatio, food, gold)) {
+            narrator() << "Not enough food\n";
+            return;
+        }
+        narrator() << "Sold " << amount << " food for " << amount * foodPrice * balance.sellRatio << " gold.\n";
+    }
+
+    // Reference price for any commodity; raw materials have fixed base prices
+    int getPrice(Commodity commodity) const {
+        static const int basePrices[COMMODITY_COUNT] = { 1, 5, 2, 3, 4 };
+        switch (commodity) {
+        case COMMODITY_FOOD: return foodPrice;
+        case COMMODITY_WEAPONS: return weaponPrice;
+        default: return basePrices[commodity];
+        }
+    }
+
+    void updatePrices(Random& rng) {
+        foodPrice += Random::bounded(rng.draw(Random::STREAM_MARKET, 0), 3) - 1; // -1 to +1 change
+        weaponPrice += Random::bounded(rng.draw(Random::STREAM_MARKET, 1), 5) - 2; // -2 to +2 change
+        if (foodPrice < 1) foodPrice = 1;
+        if (weaponPrice < 3) weaponPrice = 3;
+    }
+
+    int getFoodPrice() const {
+        return foodPrice;
+    }
+
+    int getWeaponPrice() const {
+        return weaponPrice;
+    }
+
+    void setPrices(int food, int weapon) {
+        foodPrice = food;
+        weaponPrice = weapon;
+    }
+
+    void showPrices() const {
+        narrator() << "Market Prices:\n";
+        narrator() << "Food: " << foodPrice << " gold per unit\n";
+        narrator() << "Weapons: " << weaponPrice << " gold per unit\n";
+    }
+};
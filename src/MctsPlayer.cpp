@@ -0,0 +1,222 @@
+#include "MctsPlayer.h"
+#include "Kingdom.h"
+#include "Narrator.h"
+#include <chrono>
+#include <cmath>
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Same rule as Kingdom::play: a rejected action still ends the turn
+static void playTurn(Kingdom& kingdom, const PlayerAction& action) {
+    if (!kingdom.step(action) && !kingdom.isGameOver()) {
+        kingdom.step(PlayerAction(ACTION_WAIT));
+    }
+}
+
+MctsPlayer::MctsPlayer(const MctsConfig& cfg) :
+    config(cfg), pool(cfg.threads), lastChoice(-1), lastTurn(-1),
+    decisions(0), lastIterations(0), lastSeconds(0.0),
+    lastProbes(0), lastHits(0), totalProbes(0), totalHits(0) {
+    candidates.push_back(PlayerAction(ACTION_COLLECT_TAXES));
+    candidates.push_back(PlayerAction(ACTION_SET_TAX_RATE, 10));
+    candidates.push_back(PlayerAction(ACTION_SET_TAX_RATE, 30));
+    candidates.push_back(PlayerAction(ACTION_RECRUIT, 5));
+    candidates.push_back(PlayerAction(ACTION_TRAIN));
+    candidates.push_back(PlayerAction(ACTION_TRADE_FOOD, 100, 1));
+    candidates.push_back(PlayerAction(ACTION_TRADE_FOOD, 100, 2));
+    candidates.push_back(PlayerAction(ACTION_BUILD_FARM));
+    candidates.push_back(PlayerAction(ACTION_BUILD_BARRACKS));
+    candidates.push_back(PlayerAction(ACTION_TAKE_LOAN, 500, 5));
+    candidates.push_back(PlayerAction(ACTION_WAIT));
+    trees.resize(pool.size());
+    if (config.cacheSlots > 0) cache.reset(new TranspositionTable(config.cacheSlots));
+}
+
+double MctsPlayer::evaluate(const Kingdom& kingdom) const {
+    double progress = static_cast<double>(kingdom.turn) / kingdom.getBalance().winTurn;
+    if (progress > 1.0) progress = 1.0;
+    switch (kingdom.getOutcome()) {
+    case OUTCOME_WIN:
+        return 1.0;
+    case OUTCOME_IN_PROGRESS:
+        return 0.4 + 0.2 * kingdom.population.getHappiness() / 100.0;
+    default:
+        return 0.4 * progress;
+    }
+}
+
+int MctsPlayer::select(const Tree& tree, int node) const {
+    const Node& parent = tree.nodes[node];
+    double logVisits = log(static_cast<double>(parent.visits) + 1.0);
+    int best = parent.firstChild;
+    double bestScore = -1.0;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        int child = parent.firstChild + static_cast<int>(i);
+        const Node& c = tree.nodes[child];
+        if (c.visits == 0) return child;
+        double score = c.value / c.visits + config.exploration * sqrt(logVisits / c.visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = child;
+        }
+    }
+    return best;
+}
+
+void MctsPlayer::search(Tree& tree, const Kingdom& root, uint64_t streamSeed, double deadline) const {
+    Kingdom sim(root);
+    vector<int> path;
+    int actionCount = static_cast<int>(candidates.size());
+    uint64_t start = tree.iterations;
+
+    while (true) {
+        uint64_t done = tree.iterations - start;
+        if (config.maxIterations > 0 && done >= config.maxIterations) break;
+        if ((done & 15) == 0 && now() >= deadline) break;
+
+        sim = root;
+        sim.rng.seed(Random::mixSeed(streamSeed, tree.iterations));
+        sim.rng.seek(root.rng.getTurn(), root.rng.getCounter());
+        Random rollout(Random::mixSeed(~streamSeed, tree.iterations));
+        tree.iterations++;
+
+        // Selection
+        path.clear();
+        int node = 0;
+        path.push_back(node);
+        while (tree.nodes[node].firstChild >= 0 && !sim.isGameOver()) {
+            node = select(tree, node);
+            path.push_back(node);
+            playTurn(sim, candidates[node - tree.nodes[path[path.size() - 2]].firstChild]);
+        }
+
+        // Expansion
+        if (!sim.isGameOver() && (tree.nodes[node].visits > 0 || node == 0)) {
+            int first = static_cast<int>(tree.nodes.size());
+            tree.nodes[node].firstChild = first;
+            for (int i = 0; i < actionCount; i++) {
+                Node child = { -1, 0, 0.0 };
+                tree.nodes.push_back(child);
+            }
+            int pick = rollout.next(actionCount);
+            node = first + pick;
+            path.push_back(node);
+            playTurn(sim, candidates[pick]);
+        }
+
+        // Rollout, unless the table already has enough of them for this
+        // position. A finished game is evaluated directly, so it skips the table.
+        double value;
+        uint64_t key = 0;
+        CachedValue cached;
+        bool probed = cache && !sim.isGameOver();
+        if (probed) {
+            key = sim.hash();
+            tree.probes++;
+            if (!cache->find(key, cached)) cached = CachedValue();
+        }
+        if (probed && cached.samples >= config.cacheSamples) {
+            tree.hits++;
+            value = cached.mean();
+        }
+        else {
+            int stopTurn = sim.turn + config.rolloutTurns;
+            while (!sim.isGameOver() && sim.turn < stopTurn) {
+                playTurn(sim, candidates[rollout.next(actionCount)]);
+            }
+            value = evaluate(sim);
+            if (probed) {
+                cached.total += static_cast<float>(value);
+                cached.samples++;
+                cache->store(key, cached);
+            }
+        }
+
+        // Backpropagation
+        for (size_t i = 0; i < path.size(); i++) {
+            tree.nodes[path[i]].visits++;
+            tree.nodes[path[i]].value += value;
+        }
+    }
+}
+
+// Makes the given child of the root the new root, keeping its whole subtree
+void MctsPlayer::reroot(Tree& tree, int child) const {
+    vector<Node> kept;
+    vector<pair<int, int>> queue; // (old index, new index)
+    kept.push_back(tree.nodes[child]);
+    queue.push_back(make_pair(child, 0));
+    for (size_t q = 0; q < queue.size(); q++) {
+        int oldIndex = queue[q].first;
+        int newIndex = queue[q].second;
+        int firstChild = tree.nodes[oldIndex].firstChild;
+        if (firstChild < 0) continue;
+        kept[newIndex].firstChild = static_cast<int>(kept.size());
+        for (size_t i = 0; i < candidates.size(); i++) {
+            int oldChild = firstChild + static_cast<int>(i);
+            queue.push_back(make_pair(oldChild, static_cast<int>(kept.size())));
+            kept.push_back(tree.nodes[oldChild]);
+        }
+    }
+    tree.nodes.swap(kept);
+}
+
+PlayerAction MctsPlayer::nextAction(const Kingdom& kingdom) {
+    double start = now();
+    bool reuse = lastChoice >= 0 && kingdom.turn == lastTurn + 1;
+    for (size_t t = 0; t < trees.size(); t++) {
+        Tree& tree = trees[t];
+        if (reuse && !tree.nodes.empty() && tree.nodes[0].firstChild >= 0) {
+            reroot(tree, tree.nodes[0].firstChild + lastChoice);
+        }
+        else {
+            tree.nodes.clear();
+            Node root = { -1, 0, 0.0 };
+            tree.nodes.push_back(root);
+        }
+        tree.iterations = 0;
+        tree.probes = 0;
+        tree.hits = 0;
+    }
+
+    Kingdom root = kingdom.fork();
+    double deadline = start + 1.0 / config.decisionsPerSecond;
+    uint64_t decision = decisions++;
+    pool.parallelFor(trees.size(), 1, [&](unsigned, size_t begin, size_t end) {
+        Narrator previous = narrator();
+        narrator().mute();
+        for (size_t t = begin; t < end; t++) {
+            search(trees[t], root, Random::mixSeed(config.seed, decision * trees.size() + t), deadline);
+        }
+        narrator() = previous;
+    });
+
+    vector<uint64_t> visits(candidates.size(), 0);
+    lastIterations = 0;
+    lastProbes = 0;
+    lastHits = 0;
+    for (size_t t = 0; t < trees.size(); t++) {
+        const Tree& tree = trees[t];
+        lastIterations += tree.iterations;
+        lastProbes += tree.probes;
+        lastHits += tree.hits;
+        if (tree.nodes[0].firstChild < 0) continue;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            visits[i] += tree.nodes[tree.nodes[0].firstChild + i].visits;
+        }
+    }
+    int best = static_cast<int>(candidates.size()) - 1;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (visits[i] > visits[best]) best = static_cast<int>(i);
+    }
+
+    totalProbes += lastProbes;
+    totalHits += lastHits;
+
+    lastChoice = best;
+    lastTurn = kingdom.turn;
+    lastSeconds = now() - start;
+    return candidates[best];
+}
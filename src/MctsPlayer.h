@@ -0,0 +1,97 @@
+#pragma once
+#include "GameTypes.h"
+#include "ActionSource.h"
+#include "WorkStealingPool.h"
+#include "TranspositionTable.h"
+
+struct MctsConfig {
+    unsigned threads;            // search trees, one per pool worker (0 = all cores)
+    double decisionsPerSecond;   // time budget: each decision gets 1 / decisionsPerSecond
+    unsigned maxIterations;      // per tree and decision (0 = only the time budget)
+    double exploration;          // UCT exploration constant
+    int rolloutTurns;            // random play-out length before evaluating
+    size_t cacheSlots;           // transposition table size (0 = no table)
+    unsigned cacheSamples;       // rollouts a position gets before its mean is reused
+    uint64_t seed;
+
+    MctsConfig() : threads(0), decisionsPerSecond(20.0), maxIterations(0),
+        exploration(1.0), rolloutTurns(20), cacheSlots(1 << 16), cacheSamples(2), seed(1) {}
+};
+
+// Monte Carlo Tree Search player. It searches over action sequences (open
+// loop): every iteration copies the root kingdom and reseeds its random
+// stream, so the tree learns how actions do on average
+// rather than against one known future. Search is root-parallel: each pool
+// worker grows its own tree, and the root visit counts are summed to pick
+// the move. After a move, the subtree under it is kept for the next decision.
+// Different action sequences often lead to the same kingdom, so the trees
+// share a transposition table keyed by Kingdom::hash(): once a leaf position
+// has been rolled out cacheSamples times, later visits use the stored mean
+// instead of simulating again. The table lives as long as the player.
+class MctsPlayer : public ActionSource {
+private:
+    struct Node {
+        int firstChild;   // -1 until expanded; children are contiguous
+        uint32_t visits;
+        double value;
+    };
+
+    struct Tree {
+        vector<Node> nodes;
+        uint64_t iterations;
+        uint64_t probes;   // leaf positions looked up in the cache
+        uint64_t hits;     // of those, answered without a rollout
+    };
+
+    MctsConfig config;
+    WorkStealingPool pool;
+    vector<PlayerAction> candidates;
+    vector<Tree> trees;
+    unique_ptr<TranspositionTable> cache;
+    int lastChoice;
+    int lastTurn;
+    uint64_t decisions;
+    uint64_t lastIterations;
+    double lastSeconds;
+    uint64_t lastProbes;
+    uint64_t lastHits;
+    uint64_t totalProbes;
+    uint64_t totalHits;
+
+    void search(Tree& tree, const Kingdom& root, uint64_t streamSeed, double deadline) const;
+    void reroot(Tree& tree, int child) const;
+    int select(const Tree& tree, int node) const;
+    double evaluate(const Kingdom& kingdom) const;
+
+public:
+    explicit MctsPlayer(const MctsConfig& cfg = MctsConfig());
+
+    PlayerAction nextAction(const Kingdom& kingdom) override;
+
+    // The discrete actions the search chooses between
+    const vector<PlayerAction>& actions() const {
+        return candidates;
+    }
+
+    uint64_t iterationsLastDecision() const {
+        return lastIterations;
+    }
+
+    double secondsLastDecision() const {
+        return lastSeconds;
+    }
+
+    // Share of leaf evaluations the transposition table answered, for the
+    // last decision and for every decision so far (0 without a table)
+    double cacheHitRateLastDecision() const {
+        return lastProbes ? static_cast<double>(lastHits) / lastProbes : 0.0;
+    }
+
+    double cacheHitRate() const {
+        return totalProbes ? static_cast<double>(totalHits) / totalProbes : 0.0;
+    }
+
+    uint64_t cacheProbes() const {
+        return totalProbes;
+    }
+};
@@ -0,0 +1,78 @@
+#include "MonteCarloRunner.h"
+#include "Kingdom.h"
+#include "Narrator.h"
+#include "Telemetry.h"
+#include "CheckpointStream.h"
+#include <chrono>
+
+void SimulationReport::print(ostream& out) const {
+    out << "Games: " << games << "  Turns: " << turns << "  Time: " << seconds << "s\n";
+    if (seconds > 0) {
+        out << "Games/sec: " << games / seconds << "  Turns/sec: " << turns / seconds << "\n";
+    }
+    for (int i = 0; i < OUTCOME_COUNT; i++) {
+        if (outcomes[i] == 0) continue;
+        out << "  " << outcomeName(static_cast<GameOutcome>(i)) << ": " << outcomes[i]
+            << " (" << 100.0 * outcomes[i] / games << "%)\n";
+    }
+}
+
+SimulationReport MonteCarloRunner::run(Difficulty diff, uint64_t games, uint64_t baseSeed,
+    const PolicyActionSource::Policy& policy, TelemetryWriter* telemetry, CheckpointWriter* checkpoints) {
+    vector<SimulationReport> perWorker(pool.size());
+    auto start = chrono::steady_clock::now();
+
+    pool.parallelFor(games, 256, [&](unsigned worker, size_t begin, size_t end) {
+        Narrator previous = narrator();
+        narrator().mute();
+        SimulationReport& local = perWorker[worker];
+        TelemetryChunk* chunk = telemetry ? telemetry->acquire() : nullptr;
+        CheckpointChunk* frames = checkpoints ? checkpoints->acquire() : nullptr;
+        // The difficulty is fixed for the run, so the turn loop is the
+        // instantiation for it rather than a dispatch every turn
+        dispatchDifficulty(diff, [&](auto tag) {
+            for (size_t i = begin; i < end; i++) {
+                uint64_t seed = Random::mixSeed(baseSeed, i);
+                RuledKingdom<decltype(tag)::value> kingdom(seed);
+                kingdom.useBalance(&balance);
+                PolicyActionSource player(policy, ~seed);
+                if (!chunk && !frames) {
+                    kingdom.play(player);
+                }
+                else {
+                    CheckpointEncoder encoder(checkpoints ? checkpoints->keyframeInterval() : 1);
+                    while (!kingdom.isGameOver()) {
+                        kingdom.playTurn(player);
+                        if (chunk) {
+                            chunk->append(static_cast<uint32_t>(i), kingdom);
+                            if (chunk->full()) {
+                                telemetry->submit(chunk);
+                                chunk = telemetry->acquire();
+                            }
+                        }
+                        if (frames) {
+                            encoder.encode(static_cast<uint32_t>(i), kingdom, *frames);
+                            if (frames->full()) {
+                                checkpoints->submit(frames);
+                                frames = checkpoints->acquire();
+                            }
+                        }
+                    }
+                }
+                local.games++;
+                local.turns += kingdom.turn;
+                local.outcomes[kingdom.getOutcome()]++;
+            }
+        });
+        if (chunk) telemetry->submit(chunk);
+        if (frames) checkpoints->submit(frames);
+        narrator() = previous;
+    });
+
+    SimulationReport total;
+    for (size_t i = 0; i < perWorker.size(); i++) {
+        total.merge(perWorker[i]);
+    }
+    total.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return total;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "GameTypes.h"
+#include "ActionSource.h"
+#include "WorkStealingPool.h"
+#include "BalanceParams.h"
+
+class TelemetryWriter;
+class CheckpointWriter;
+
+// Totals for a batch of simulated games. Each worker fills its own copy,
+// padded to a cache line, and the copies are merged after the run.
+struct alignas(64) SimulationReport {
+    uint64_t games;
+    uint64_t turns;
+    uint64_t outcomes[OUTCOME_COUNT];
+    double seconds;
+
+    SimulationReport() : games(0), turns(0), seconds(0.0) {
+        for (int i = 0; i < OUTCOME_COUNT; i++) outcomes[i] = 0;
+    }
+
+    void merge(const SimulationReport& other) {
+        games += other.games;
+        turns += other.turns;
+        for (int i = 0; i < OUTCOME_COUNT; i++) outcomes[i] += other.outcomes[i];
+    }
+
+    void print(ostream& out) const;
+};
+
+// Plays many independent headless games in parallel. Game i is seeded with
+// Random::mixSeed(baseSeed, i), so a run is reproducible for any thread count.
+// With a telemetry writer, every turn of every game is recorded as a row;
+// with a checkpoint writer, the full state after every turn is checkpointed
+// under the game's index.
+// Games play by the runner's balance constants, the standard ones unless
+// setBalance says otherwise.
+class MonteCarloRunner {
+private:
+    WorkStealingPool pool;
+    BalanceParams balance;
+public:
+    explicit MonteCarloRunner(unsigned threads = 0) : pool(threads) {}
+
+    unsigned threadCount() const {
+        return pool.size();
+    }
+
+    void setBalance(const BalanceParams& params) {
+        balance = params;
+    }
+
+    const BalanceParams& getBalance() const {
+        return balance;
+    }
+
+    SimulationReport run(Difficulty diff, uint64_t games, uint64_t baseSeed,
+        const PolicyActionSource::Policy& policy = randomPolicy, TelemetryWriter* telemetry = nullptr,
+        CheckpointWriter* checkpoints = nullptr);
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include "GameTypes.h"
+#include <thread>
+#include <chrono>
+
+// All game narration goes through the narrator instead of cout, so headless
+// runs can switch it off together with the pauses meant for human players.
+class Narrator {
+private:
+    ostream* out;
+    bool paced;
+public:
+    Narrator() : out(&cout), paced(true) {}
+
+    template <typename T>
+    Narrator& operator<<(const T& value) {
+        if (out) *out << value;
+        return *this;
+    }
+
+    Narrator& operator<<(ostream& (*manip)(ostream&)) {
+        if (out) manip(*out);
+        return *this;
+    }
+
+    void setOutput(ostream* o) { out = o; }
+    void setPaced(bool p) { paced = p; }
+    void mute() {
+        out = nullptr;
+        paced = false;
+    }
+    bool isEnabled() const { return out != nullptr; }
+
+    void pause(int milliseconds) const {
+        if (paced) this_thread::sleep_for(chrono::milliseconds(milliseconds));
+    }
+
+    void clearScreen() const {
+        if (paced) system("cls");
+    }
+};
+
+// One narrator per thread so simulations on worker threads never share a stream
+inline Narrator& narrator() {
+    static thread_local Narrator instance;
+    return instance;
+}
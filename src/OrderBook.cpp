@@ -0,0 +1,85 @@
+#include "OrderBook.h"
+
+OrderBook::OrderBook() :
+    bidDepth(BOOK_PRICE_LEVELS, 0), askDepth(BOOK_PRICE_LEVELS, 0), demand(BOOK_PRICE_LEVELS + 1, 0),
+    lowLevel(BOOK_PRICE_LEVELS), highLevel(0) {
+    last.price = 0;
+    last.volume = 0;
+}
+
+uint32_t OrderBook::submit(OrderSide side, uint32_t owner, int32_t price, int32_t quantity) {
+    if (price < 1) price = 1;
+    if (price >= BOOK_PRICE_LEVELS) price = BOOK_PRICE_LEVELS - 1;
+    BookOrder o = { owner, price, quantity, 0, side };
+    orders.push_back(o);
+    if (quantity > 0) {
+        (side == SIDE_BUY ? bidDepth : askDepth)[price] += quantity;
+        if (price < lowLevel) lowLevel = price;
+        if (price > highLevel) highLevel = price;
+    }
+    return static_cast<uint32_t>(orders.size() - 1);
+}
+
+AuctionResult OrderBook::clear(int32_t referencePrice) {
+    last.price = 0;
+    last.volume = 0;
+    if (lowLevel > highLevel) return last;
+
+    demand[highLevel + 1] = 0;
+    for (int p = highLevel; p >= lowLevel; p--) {
+        demand[p] = demand[p + 1] + bidDepth[p];
+    }
+
+    int64_t supply = 0;
+    int64_t bestImbalance = 0;
+    for (int p = lowLevel; p <= highLevel; p++) {
+        supply += askDepth[p];
+        int64_t volume = min(demand[p], supply);
+        if (volume == 0) continue;
+        int64_t imbalance = demand[p] > supply ? demand[p] - supply : supply - demand[p];
+        bool better = volume > last.volume
+            || (volume == last.volume && imbalance < bestImbalance)
+            || (volume == last.volume && imbalance == bestImbalance
+                && abs(p - referencePrice) < abs(last.price - referencePrice));
+        if (better) {
+            last.price = p;
+            last.volume = volume;
+            bestImbalance = imbalance;
+        }
+    }
+    if (last.volume == 0) return last;
+
+    // Turn the depth arrays into per-level fill budgets: the volume goes to the
+    // best-priced levels first, and within a level first come first served.
+    int64_t remaining = last.volume;
+    for (int p = highLevel; p >= lowLevel; p--) {
+        int64_t take = p >= last.price ? min(bidDepth[p], remaining) : 0;
+        bidDepth[p] = take;
+        remaining -= take;
+    }
+    remaining = last.volume;
+    for (int p = lowLevel; p <= highLevel; p++) {
+        int64_t take = p <= last.price ? min(askDepth[p], remaining) : 0;
+        askDepth[p] = take;
+        remaining -= take;
+    }
+
+    for (size_t i = 0; i < orders.size(); i++) {
+        BookOrder& o = orders[i];
+        if (o.quantity <= 0) continue;
+        int64_t& budget = (o.side == SIDE_BUY ? bidDepth : askDepth)[o.price];
+        o.filled = static_cast<int32_t>(min<int64_t>(o.quantity, budget));
+        budget -= o.filled;
+    }
+    return last;
+}
+
+void OrderBook::reset() {
+    orders.clear();
+    for (int p = lowLevel; p <= highLevel; p++) {
+        bidDepth[p] = 0;
+        askDepth[p] = 0;
+    }
+    lowLevel = BOOK_PRICE_LEVELS;
+    highLevel = 0;
+}
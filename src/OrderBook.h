@@ -0,0 +1,80 @@
+#pragma once
+#include "GameTypes.h"
+
+// Prices are whole gold pieces in [1, BOOK_PRICE_LEVELS)
+const int BOOK_PRICE_LEVELS = 1024;
+
+struct BookOrder {
+    uint32_t owner;
+    int32_t price;
+    int32_t quantity;
+    int32_t filled;
+    OrderSide side;
+};
+
+struct AuctionResult {
+    int32_t price;   // 0 if nothing traded
+    int64_t volume;
+};
+
+// Limit order book for one commodity, cleared as a single-price call auction.
+// Orders collect during a turn; each price level only keeps the total resting
+// quantity per side, so clearing is a few passes over a flat array instead of
+// a walk through per-order queues. Better-priced orders fill first; orders at
+// the same price fill in the order they were submitted.
+class OrderBook {
+private:
+    vector<BookOrder> orders;
+    vector<int64_t> bidDepth;
+    vector<int64_t> askDepth;
+    vector<int64_t> demand;  // scratch: total bid quantity at or above each price
+    int lowLevel;
+    int highLevel;
+    AuctionResult last;
+
+public:
+    OrderBook();
+
+    // Queues an order for the next clear and returns its id. Prices outside
+    // the book are clamped; non-positive quantities are kept but never fill.
+    uint32_t submit(OrderSide side, uint32_t owner, int32_t price, int32_t quantity);
+
+    // Picks the price that trades the most volume (ties: smallest leftover
+    // imbalance, then closest to referencePrice, then lowest), fills the
+    // orders and returns the result. Every fill trades at that one price.
+    // Call once per batch; reset before submitting the next one.
+    AuctionResult clear(int32_t referencePrice);
+
+    // Drops all orders, ready for the next turn
+    void reset();
+
+    size_t size() const {
+        return orders.size();
+    }
+
+    const BookOrder& order(uint32_t id) const {
+        return orders[id];
+    }
+
+    const AuctionResult& lastResult() const {
+        return last;
+    }
+};
+
+// One order book per commodity
+class Exchange {
+private:
+    OrderBook books[COMMODITY_COUNT];
+public:
+    OrderBook& book(Commodity commodity) {
+        return books[commodity];
+    }
+
+    const OrderBook& book(Commodity commodity) const {
+        return books[commodity];
+    }
+
+    void reset() {
+        for (int c = 0; c < COMMODITY_COUNT; c++) books[c].reset();
+    }
+};
@@ -0,0 +1,185 @@
+#include "Population.h"
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define POPULATION_SIMD 1
+#endif
+
+// Share of each class in each age band for a freshly created population
+static const float AGE_SHAPE[CLASS_COUNT][AGE_COUNT] = {
+    { 0.25f, 0.15f, 0.45f, 0.15f },  // peasants
+    { 0.25f, 0.15f, 0.45f, 0.15f },  // merchants
+    { 0.25f, 0.15f, 0.45f, 0.15f },  // nobility
+    { 0.00f, 0.30f, 0.70f, 0.00f },  // soldiers are all of fighting age
+};
+
+// Per-turn transition matrix, stored column-major: column j holds where the
+// people of cohort j are next turn (including j itself), so the update is
+// next = sum over j of column(j) * cohort[j]. Only 9 of the 16 class-to-class
+// 4x4 blocks are non-zero, so the update runs over that block list: each
+// block maps the age vector of one class, a single SIMD register, onto
+// another class.
+struct TransitionMatrix {
+    struct Block {
+        alignas(16) float column[AGE_COUNT][AGE_COUNT];
+        int from;
+        int to;
+    };
+
+    float column[COHORT_COUNT][COHORT_COUNT];
+    Block blocks[CLASS_COUNT * CLASS_COUNT];
+    int blockCount;
+
+    void flow(SocialClass fromClass, AgeBand fromAge, SocialClass toClass, AgeBand toAge, float rate) {
+        column[fromClass * AGE_COUNT + fromAge][toClass * AGE_COUNT + toAge] += rate;
+    }
+
+    TransitionMatrix() {
+        for (int j = 0; j < COHORT_COUNT; j++) {
+            for (int i = 0; i < COHORT_COUNT; i++) column[j][i] = 0.0f;
+        }
+
+        // Survival and aging: stay, move up a band, or die (the remainder)
+        static const float AGE_UP[AGE_COUNT] = { 0.10f, 0.10f, 0.04f, 0.0f };
+        static const float DEATH[AGE_COUNT] = { 0.02f, 0.005f, 0.01f, 0.08f };
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            SocialClass sc = static_cast<SocialClass>(c);
+            for (int a = 0; a < AGE_COUNT; a++) {
+                AgeBand age = static_cast<AgeBand>(a);
+                flow(sc, age, sc, age, 1.0f - AGE_UP[a] - DEATH[a]);
+                if (a + 1 < AGE_COUNT) flow(sc, age, sc, static_cast<AgeBand>(a + 1), AGE_UP[a]);
+            }
+        }
+
+        // Births to adults; soldiers' children grow up as peasants
+        flow(CLASS_PEASANT, AGE_ADULT, CLASS_PEASANT, AGE_CHILD, 0.07f);
+        flow(CLASS_MERCHANT, AGE_ADULT, CLASS_MERCHANT, AGE_CHILD, 0.06f);
+        flow(CLASS_NOBILITY, AGE_ADULT, CLASS_NOBILITY, AGE_CHILD, 0.05f);
+        flow(CLASS_SOLDIER, AGE_ADULT, CLASS_PEASANT, AGE_CHILD, 0.04f);
+
+        // Young peasants enlist
+        flow(CLASS_PEASANT, AGE_YOUTH, CLASS_PEASANT, AGE_YOUTH, -0.04f);
+        flow(CLASS_PEASANT, AGE_YOUTH, CLASS_SOLDIER, AGE_YOUTH, 0.04f);
+
+        // Migration between classes among adults
+        flow(CLASS_PEASANT, AGE_ADULT, CLASS_PEASANT, AGE_ADULT, -0.012f);
+        flow(CLASS_PEASANT, AGE_ADULT, CLASS_MERCHANT, AGE_ADULT, 0.01f);
+        flow(CLASS_PEASANT, AGE_ADULT, CLASS_SOLDIER, AGE_ADULT, 0.002f);
+        flow(CLASS_MERCHANT, AGE_ADULT, CLASS_MERCHANT, AGE_ADULT, -0.007f);
+        flow(CLASS_MERCHANT, AGE_ADULT, CLASS_PEASANT, AGE_ADULT, 0.005f);
+        flow(CLASS_MERCHANT, AGE_ADULT, CLASS_NOBILITY, AGE_ADULT, 0.002f);
+        // Veterans retire to the land instead of growing old in the ranks
+        flow(CLASS_SOLDIER, AGE_ADULT, CLASS_SOLDIER, AGE_ELDER, -0.04f);
+        flow(CLASS_SOLDIER, AGE_ADULT, CLASS_PEASANT, AGE_ELDER, 0.04f);
+
+        blockCount = 0;
+        for (int to = 0; to < CLASS_COUNT; to++) {
+            for (int from = 0; from < CLASS_COUNT; from++) {
+                Block& b = blocks[blockCount];
+                bool used = false;
+                for (int a = 0; a < AGE_COUNT; a++) {
+                    for (int i = 0; i < AGE_COUNT; i++) {
+                        b.column[a][i] = column[from * AGE_COUNT + a][to * AGE_COUNT + i];
+                        used = used || b.column[a][i] != 0.0f;
+                    }
+                }
+                b.from = from;
+                b.to = to;
+                if (used) blockCount++;
+            }
+        }
+    }
+};
+
+static const TransitionMatrix& transitions() {
+    static const TransitionMatrix matrix;
+    return matrix;
+}
+
+Population::Population(int p, int m, int n, int s, int h) : happiness(h) {
+    setClass(CLASS_PEASANT, static_cast<float>(p));
+    setClass(CLASS_MERCHANT, static_cast<float>(m));
+    setClass(CLASS_NOBILITY, static_cast<float>(n));
+    setClass(CLASS_SOLDIER, static_cast<float>(s));
+    for (int c = 0; c < CLASS_COUNT; c++) counts[c] = 0;
+    rehash();
+    recount();
+}
+
+void Population::setClass(SocialClass c, float count) {
+    for (int a = 0; a < AGE_COUNT; a++) {
+        cohorts[cohort(c, static_cast<AgeBand>(a))] = count * AGE_SHAPE[c][a];
+    }
+}
+
+void Population::scaleClass(SocialClass c, float change) {
+    float total = classTotal(c);
+    if (total <= 0.0f) {
+        if (change > 0.0f) setClass(c, change);
+        setCount(c, static_cast<int>(classTotal(c) + 0.5f));
+        return;
+    }
+    float factor = (total + change) / total;
+    if (factor < 0.0f) factor = 0.0f;
+    float* band = cohorts + c * AGE_COUNT;
+    for (int a = 0; a < AGE_COUNT; a++) band[a] *= factor;
+    setCount(c, static_cast<int>(classTotal(c) + 0.5f));
+}
+
+void Population::advance() {
+    float next[COHORT_COUNT];
+    project(cohorts, next);
+    for (int i = 0; i < COHORT_COUNT; i++) cohorts[i] = next[i];
+    recount();
+}
+
+void Population::advanceScalar() {
+    float next[COHORT_COUNT];
+    projectScalar(cohorts, next);
+    for (int i = 0; i < COHORT_COUNT; i++) cohorts[i] = next[i];
+    recount();
+}
+
+// Each block's four products are summed pairwise before joining the
+// destination total, which keeps the add chains short. Blocks are ordered by
+// destination class, and both paths add the terms in the same order, so they give the same results lane for lane.
+void Population::project(const float* current, float* next) {
+#ifdef POPULATION_SIMD
+    const TransitionMatrix& m = transitions();
+    __m128 total[CLASS_COUNT];
+    for (int c = 0; c < CLASS_COUNT; c++) total[c] = _mm_setzero_ps();
+    for (int k = 0; k < m.blockCount; k++) {
+        const TransitionMatrix::Block& b = m.blocks[k];
+        const float* from = current + b.from * AGE_COUNT;
+        __m128 p0 = _mm_mul_ps(_mm_load_ps(b.column[0]), _mm_set1_ps(from[0]));
+        __m128 p1 = _mm_mul_ps(_mm_load_ps(b.column[1]), _mm_set1_ps(from[1]));
+        __m128 p2 = _mm_mul_ps(_mm_load_ps(b.column[2]), _mm_set1_ps(from[2]));
+        __m128 p3 = _mm_mul_ps(_mm_load_ps(b.column[3]), _mm_set1_ps(from[3]));
+        total[b.to] = _mm_add_ps(total[b.to], _mm_add_ps(_mm_add_ps(p0, p1), _mm_add_ps(p2, p3)));
+    }
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        _mm_storeu_ps(next + c * AGE_COUNT, total[c]);
+    }
+#else
+    projectScalar(current, next);
+#endif
+}
+
+void Population::projectScalar(const float* current, float* next) {
+    const TransitionMatrix& m = transitions();
+    for (int i = 0; i < COHORT_COUNT; i++) next[i] = 0.0f;
+    for (int k = 0; k < m.blockCount; k++) {
+        const TransitionMatrix::Block& b = m.blocks[k];
+        const float* from = current + b.from * AGE_COUNT;
+        float* to = next + b.to * AGE_COUNT;
+        for (int i = 0; i < AGE_COUNT; i++) {
+            float p0 = b.column[0][i] * from[0];
+            float p1 = b.column[1][i] * from[1];
+            float p2 = b.column[2][i] * from[2];
+            float p3 = b.column[3][i] * from[3];
+            float low = p0 + p1;
+            float high = p2 + p3;
+            float block = low + high;
+            to[i] = to[i] + block;
+        }
+    }
+}
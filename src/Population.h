@@ -0,0 +1,180 @@
+#pragma once
+#include "Narrator.h"
+#include "Zobrist.h"
+#include <cstring>
+
+struct KingdomRecord;
+
+enum SocialClass {
+    CLASS_PEASANT,
+    CLASS_MERCHANT,
+    CLASS_NOBILITY,
+    CLASS_SOLDIER,
+    CLASS_COUNT
+};
+
+enum AgeBand {
+    AGE_CHILD,
+    AGE_YOUTH,
+    AGE_ADULT,
+    AGE_ELDER,
+    AGE_COUNT
+};
+
+const int COHORT_COUNT = CLASS_COUNT * AGE_COUNT;
+
+// People are tracked as age/class cohorts, cohort index class * AGE_COUNT + age.
+// Counts are fractional so small rates accumulate between turns; the rounded
+// class totals are cached whenever the cohorts change. Each turn, advance() applies births, deaths, aging and
+// migration between classes as one fixed 16x16 matrix-vector product.
+class Population {
+private:
+    float cohorts[COHORT_COUNT];
+    int counts[CLASS_COUNT];
+    int happiness;
+    uint64_t zobrist;   // keys of the class counts and happiness; see hash()
+    friend class Disasters;
+    friend struct KingdomRecord;
+
+    static int cohort(SocialClass c, AgeBand a) {
+        return c * AGE_COUNT + a;
+    }
+
+    float classTotal(SocialClass c) const {
+        const float* band = cohorts + c * AGE_COUNT;
+        return band[AGE_CHILD] + band[AGE_YOUTH] + band[AGE_ADULT] + band[AGE_ELDER];
+    }
+
+    // Caches the class counts; only the ones that moved are rehashed
+    void recount() {
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            int count = static_cast<int>(classTotal(static_cast<SocialClass>(c)) + 0.5f);
+            if (count != counts[c]) setCount(static_cast<SocialClass>(c), count);
+        }
+    }
+
+    // Hashes the counts and happiness from scratch, after they were written
+    // directly
+    void rehash() {
+        zobrist = zobristKey(HASH_HAPPINESS, happiness);
+        for (int c = 0; c < CLASS_COUNT; c++) zobrist ^= zobristKey(HASH_CLASS + c, counts[c]);
+    }
+
+    void setCount(SocialClass c, int count) {
+        zobrist ^= zobristKey(HASH_CLASS + c, counts[c]) ^ zobristKey(HASH_CLASS + c, count);
+        counts[c] = count;
+    }
+
+    // Spreads a class count over the age bands in the default proportions
+    void setClass(SocialClass c, float count);
+
+    // Adds (or with a negative count removes) people of a class, scaling all of
+    // its age bands alike; a class never goes below zero
+    void scaleClass(SocialClass c, float change);
+
+public:
+
+    Population(int p, int m, int n, int s, int h);
+
+    int getTotal() const {
+        return counts[CLASS_PEASANT] + counts[CLASS_MERCHANT] + counts[CLASS_NOBILITY] + counts[CLASS_SOLDIER];
+    }
+
+    int getHappiness() const {
+        return happiness;
+    }
+
+    int getClass(SocialClass c) const {
+        return counts[c];
+    }
+
+    int getPeasants() const {
+        return getClass(CLASS_PEASANT);
+    }
+
+    int getMerchants() const {
+        return getClass(CLASS_MERCHANT);
+    }
+
+    int getNobility() const {
+        return getClass(CLASS_NOBILITY);
+    }
+
+    int getSoldiers() const {
+        return getClass(CLASS_SOLDIER);
+    }
+
+    float getCohort(SocialClass c, AgeBand a) const {
+        return cohorts[cohort(c, a)];
+    }
+
+    void updateHappiness(int change) {
+        int previous = happiness;
+        happiness += change;
+        if (happiness > 100) {
+            happiness = 100;
+        }
+        if (happiness < 0) {
+            happiness = 0;
+        }
+        zobrist ^= zobristKey(HASH_HAPPINESS, previous) ^ zobristKey(HASH_HAPPINESS, happiness);
+    }
+
+    void addPeasants(int count) {
+        scaleClass(CLASS_PEASANT, static_cast<float>(count));
+    }
+
+    void removePeasants(int count) {
+        scaleClass(CLASS_PEASANT, -static_cast<float>(count));
+    }
+
+    void addSoldiers(int count) {
+        scaleClass(CLASS_SOLDIER, static_cast<float>(count));
+    }
+
+    // Losses per class, e.g. from a disaster
+    void lose(int peasants, int merchants, int nobility, int soldiers) {
+        scaleClass(CLASS_PEASANT, -static_cast<float>(peasants));
+        scaleClass(CLASS_MERCHANT, -static_cast<float>(merchants));
+        scaleClass(CLASS_NOBILITY, -static_cast<float>(nobility));
+        scaleClass(CLASS_SOLDIER, -static_cast<float>(soldiers));
+    }
+
+    void starve(int foodShortage) {
+        int deaths = foodShortage / 2;
+        removePeasants(deaths);
+        updateHappiness(-20);
+    }
+
+    void plague() {
+        int deaths = getTotal() * 0.1;
+        lose(deaths * 0.7, deaths * 0.15, deaths * 0.1, deaths * 0.05);
+        updateHappiness(-30);
+    }
+
+    // Zobrist hash of the class counts, happiness and the fractional cohorts
+    // behind the counts, so equal hashes mean equal futures. Every cohort
+    // moves every turn, so their keys are folded in here rather than kept
+    // up to date.
+    uint64_t hash() const {
+        uint64_t h = zobrist;
+        for (int i = 0; i < COHORT_COUNT; i++) {
+            uint32_t bits;
+            memcpy(&bits, &cohorts[i], sizeof(bits));
+            h ^= zobristKey(HASH_COHORT + i, bits);
+        }
+        return h;
+    }
+
+    // One turn of births, deaths, aging and class migration
+    void advance();
+
+    // Same update without SIMD; tests/population_kernel_test.cpp checks the
+    // two agree bit for bit
+    void advanceScalar();
+
+    // advance()'s update applied to a bare cohort array, for code that
+    // predicts the next turn from a saved record
+    static void project(const float* current, float* next);
+    static void projectScalar(const float* current, float* next);
+};
@@ -0,0 +1,194 @@
+#pragma once
+#include "GameTypes.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+// Turn phases timed by the profiler
+enum TurnPhase {
+    PHASE_ACTION,
+    PHASE_FOOD,
+    PHASE_PAY_SOLDIERS,
+    PHASE_PRODUCE,
+    PHASE_LOANS,
+    PHASE_DEMOGRAPHY,
+    PHASE_EVENTS,
+    PHASE_ELECTION,
+    PHASE_DISASTERS,
+    PHASE_MARKET,
+    PHASE_GAME_OVER,
+    PHASE_COUNT
+};
+
+inline const char* phaseName(TurnPhase phase) {
+    switch (phase) {
+    case PHASE_ACTION: return "player_action";
+    case PHASE_FOOD: return "food_consumption";
+    case PHASE_PAY_SOLDIERS: return "pay_soldiers";
+    case PHASE_PRODUCE: return "produce_resources";
+    case PHASE_LOANS: return "loan_repayments";
+    case PHASE_DEMOGRAPHY: return "demography";
+    case PHASE_EVENTS: return "random_event";
+    case PHASE_ELECTION: return "check_election";
+    case PHASE_DISASTERS: return "disasters";
+    case PHASE_MARKET: return "update_prices";
+    case PHASE_GAME_OVER: return "check_game_over";
+    default: return "unknown";
+    }
+}
+
+struct PhaseTotals {
+    uint64_t calls[PHASE_COUNT];
+    uint64_t nanoseconds[PHASE_COUNT];
+
+    PhaseTotals() {
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            calls[i] = 0;
+            nanoseconds[i] = 0;
+        }
+    }
+};
+
+// Per-phase call counts and time. Each thread writes only its own counters
+// (relaxed atomics, no read-modify-write), and collect() sums them with the
+// totals of threads that already exited. Timing is off until enable(true);
+// building with STRONGHOLD_NO_PROFILING removes it from the code entirely.
+class Profiler {
+private:
+    struct ThreadCounters {
+        atomic<uint64_t> calls[PHASE_COUNT];
+        atomic<uint64_t> nanoseconds[PHASE_COUNT];
+
+        ThreadCounters() {
+            for (int i = 0; i < PHASE_COUNT; i++) {
+                calls[i].store(0, memory_order_relaxed);
+                nanoseconds[i].store(0, memory_order_relaxed);
+            }
+            lock_guard<mutex> guard(registryLock());
+            registry().push_back(this);
+        }
+
+        ~ThreadCounters() {
+            lock_guard<mutex> guard(registryLock());
+            addTo(retired());
+            vector<ThreadCounters*>& all = registry();
+            for (size_t i = 0; i < all.size(); i++) {
+                if (all[i] == this) {
+                    all.erase(all.begin() + i);
+                    break;
+                }
+            }
+        }
+
+        void addTo(PhaseTotals& totals) const {
+            for (int i = 0; i < PHASE_COUNT; i++) {
+                totals.calls[i] += calls[i].load(memory_order_relaxed);
+                totals.nanoseconds[i] += nanoseconds[i].load(memory_order_relaxed);
+            }
+        }
+    };
+
+    static mutex& registryLock() {
+        static mutex lock;
+        return lock;
+    }
+
+    static vector<ThreadCounters*>& registry() {
+        static vector<ThreadCounters*> all;
+        return all;
+    }
+
+    static PhaseTotals& retired() {
+        static PhaseTotals totals;
+        return totals;
+    }
+
+    static atomic<bool>& enabledFlag() {
+        static atomic<bool> flag(false);
+        return flag;
+    }
+
+public:
+    static void enable(bool on) {
+        enabledFlag().store(on, memory_order_relaxed);
+    }
+
+    static bool isEnabled() {
+        return enabledFlag().load(memory_order_relaxed);
+    }
+
+    static void record(TurnPhase phase, uint64_t nanoseconds) {
+        static thread_local ThreadCounters counters;
+        counters.calls[phase].store(counters.calls[phase].load(memory_order_relaxed) + 1, memory_order_relaxed);
+        counters.nanoseconds[phase].store(counters.nanoseconds[phase].load(memory_order_relaxed) + nanoseconds,
+            memory_order_relaxed);
+    }
+
+    static PhaseTotals collect() {
+        lock_guard<mutex> guard(registryLock());
+        PhaseTotals totals = retired();
+        vector<ThreadCounters*>& all = registry();
+        for (size_t i = 0; i < all.size(); i++) {
+            all[i]->addTo(totals);
+        }
+        return totals;
+    }
+
+    // Only call while no profiled code is running
+    static void reset() {
+        lock_guard<mutex> guard(registryLock());
+        retired() = PhaseTotals();
+        vector<ThreadCounters*>& all = registry();
+        for (size_t i = 0; i < all.size(); i++) {
+            for (int p = 0; p < PHASE_COUNT; p++) {
+                all[i]->calls[p].store(0, memory_order_relaxed);
+                all[i]->nanoseconds[p].store(0, memory_order_relaxed);
+            }
+        }
+    }
+
+    static void writeJson(ostream& out) {
+        PhaseTotals totals = collect();
+        out << "{\n  \"phases\": [\n";
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            out << "    {\"phase\": \"" << phaseName(static_cast<TurnPhase>(i)) << "\", \"calls\": "
+                << totals.calls[i] << ", \"nanoseconds\": " << totals.nanoseconds[i] << "}"
+                << (i + 1 < PHASE_COUNT ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+    static void writeCsv(ostream& out) {
+        PhaseTotals totals = collect();
+        out << "phase,calls,nanoseconds\n";
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            out << phaseName(static_cast<TurnPhase>(i)) << "," << totals.calls[i] << ","
+                << totals.nanoseconds[i] << "\n";
+        }
+    }
+};
+
+// Times the enclosing scope as one call of a phase
+class ScopedPhaseTimer {
+private:
+    TurnPhase phase;
+    bool active;
+    chrono::steady_clock::time_point start;
+public:
+    explicit ScopedPhaseTimer(TurnPhase p) : phase(p), active(Profiler::isEnabled()) {
+        if (active) start = chrono::steady_clock::now();
+    }
+
+    ~ScopedPhaseTimer() {
+        if (active) {
+            Profiler::record(phase, static_cast<uint64_t>(
+                chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()));
+        }
+    }
+};
+
+#ifdef STRONGHOLD_NO_PROFILING
+#define PROFILE_PHASE(phase)
+#else
+#define PROFILE_PHASE(phase) ScopedPhaseTimer phaseTimer(phase)
+#endif
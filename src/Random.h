@@ -0,0 +1,101 @@
+#pragma once
+#include "GameTypes.h"
+
+// Counter-based random stream owned by one kingdom. Every value is a pure
+// function of (seed, turn, stream, draw index), so any turn can be replayed
+// from those numbers alone and threads never share generator state.
+// Stream 0 is the sequential stream used through next(); the other streams
+// are addressed directly so batch code can draw them in any order.
+class Random {
+private:
+    uint64_t key;
+    uint32_t turn;
+    uint32_t counter;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    enum Stream : uint32_t {
+        STREAM_MAIN,
+        STREAM_MARKET
+    };
+
+    Random(uint64_t seed = 1) : key(seed), turn(0), counter(0) {}
+
+    void seed(uint64_t s) {
+        key = s;
+        turn = 0;
+        counter = 0;
+    }
+
+    uint64_t getSeed() const {
+        return key;
+    }
+
+    uint32_t getTurn() const {
+        return turn;
+    }
+
+    uint32_t getCounter() const {
+        return counter;
+    }
+
+    // Restarts the sequential stream at the first draw of turn t
+    void beginTurn(uint32_t t) {
+        turn = t;
+        counter = 0;
+    }
+
+    // Positions the sequential stream at an exact (turn, draw index)
+    void seek(uint32_t t, uint32_t index) {
+        turn = t;
+        counter = index;
+    }
+
+    static uint64_t at(uint64_t seed, uint32_t t, uint32_t stream, uint32_t index) {
+        uint64_t ctr = (static_cast<uint64_t>(t) << 32) | index;
+        return mix(seed ^ mix(ctr + (stream + 1) * 0x9E3779B97F4A7C15ULL));
+    }
+
+    static int bounded(uint64_t raw, int bound) {
+        return static_cast<int>(raw % static_cast<uint64_t>(bound));
+    }
+
+    // Draw `index` of `stream` in the current turn; does not move the counter
+    uint64_t draw(uint32_t stream, uint32_t index) const {
+        return at(key, turn, stream, index);
+    }
+
+    uint64_t nextRaw() {
+        return at(key, turn, STREAM_MAIN, counter++);
+    }
+
+    // Uniform integer in [0, bound)
+    int next(int bound) {
+        return bounded(nextRaw(), bound);
+    }
+
+    // n consecutive draws of a stream in the current turn, starting at index first
+    void fill(uint32_t stream, uint32_t first, uint64_t* out, size_t n) const {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = at(key, turn, stream, first + static_cast<uint32_t>(i));
+        }
+    }
+
+    // The same draw for n different kingdoms, e.g. one lane per KingdomBatch slot
+    static void fillLanes(const uint64_t* seeds, const int32_t* turns, uint32_t stream,
+        uint32_t index, uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = at(seeds[i], static_cast<uint32_t>(turns[i]), stream, index);
+        }
+    }
+
+    // Derives well-spread seeds for game i of a run from one base seed
+    static uint64_t mixSeed(uint64_t base, uint64_t index) {
+        return mix(base + (index + 1) * 0x9E3779B97F4A7C15ULL);
+    }
+};
@@ -0,0 +1,35 @@
+#include "ReplayEngine.h"
+
+ReplayEngine::ReplayEngine(const ActionLog& actions, int interval) :
+    log(actions), checkpointInterval(interval > 0 ? interval : 1),
+    kingdom(actions.getDifficulty(), actions.getSeed()), position(0) {
+    checkpoint();
+}
+
+void ReplayEngine::checkpoint() {
+    if (!checkpoints.empty() && checkpoints.back().turn >= kingdom.turn) return;
+    Checkpoint c = { kingdom.turn, position, kingdom.fork() };
+    checkpoints.push_back(c);
+}
+
+bool ReplayEngine::fastForward(int targetTurn) {
+    Narrator previous = narrator();
+    narrator().mute();
+    while (kingdom.turn < targetTurn && position < log.size() && !kingdom.isGameOver()) {
+        kingdom.step(log[position++]);
+        if (kingdom.turn % checkpointInterval == 0) checkpoint();
+    }
+    narrator() = previous;
+    return kingdom.turn >= targetTurn;
+}
+
+bool ReplayEngine::seek(int targetTurn) {
+    if (targetTurn < kingdom.turn) {
+        size_t i = checkpoints.size();
+        while (i > 1 && checkpoints[i - 1].turn > targetTurn) i--;
+        const Checkpoint& c = checkpoints[i - 1];
+        kingdom = c.state;
+        position = c.position;
+    }
+    return fastForward(targetTurn);
+}
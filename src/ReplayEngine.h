@@ -0,0 +1,44 @@
+#pragma once
+#include "GameTypes.h"
+#include "ActionLog.h"
+#include "Kingdom.h"
+
+// Re-runs a recorded game without narration. fastForward moves on from the
+// current state; seek can also go backwards by restoring the nearest
+// in-memory checkpoint, taken every checkpointInterval turns on the way.
+class ReplayEngine {
+private:
+    struct Checkpoint {
+        int turn;
+        size_t position;
+        Kingdom state;
+    };
+
+    const ActionLog& log;
+    int checkpointInterval;
+    vector<Checkpoint> checkpoints;
+    Kingdom kingdom;
+    size_t position;
+
+    void checkpoint();
+
+public:
+    ReplayEngine(const ActionLog& actions, int interval = 5);
+
+    const Kingdom& state() const {
+        return kingdom;
+    }
+
+    size_t getPosition() const {
+        return position;
+    }
+
+    bool atEnd() const {
+        return position >= log.size();
+    }
+
+    // Applies logged actions until the kingdom reaches targetTurn, the game
+    // ends or the log runs out. Returns true if targetTurn was reached.
+    bool fastForward(int targetTurn);
+    bool seek(int targetTurn);
+};
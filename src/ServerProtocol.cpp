@@ -0,0 +1,117 @@
+#include "ServerProtocol.h"
+#include <cstring>
+
+// Integers are copied in host order; every supported target is little-endian
+template <typename T>
+static void put(string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static T get(const char*& p) {
+    T value;
+    memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return value;
+}
+
+static void putHeader(string& out, MessageType type, size_t payload) {
+    out.push_back(static_cast<char>(type));
+    out.push_back(static_cast<char>(payload));
+}
+
+void putNewGame(string& out, uint32_t tag, Difficulty diff, uint64_t seed) {
+    putHeader(out, MSG_NEW_GAME, NEW_GAME_PAYLOAD);
+    put<uint32_t>(out, tag);
+    put<uint8_t>(out, static_cast<uint8_t>(diff));
+    put<uint64_t>(out, seed);
+}
+
+void putAction(string& out, uint32_t tag, uint32_t session, const PlayerAction& action) {
+    putHeader(out, MSG_ACTION, ACTION_PAYLOAD);
+    put<uint32_t>(out, tag);
+    put<uint32_t>(out, session);
+    put<uint8_t>(out, static_cast<uint8_t>(action.type));
+    put<int32_t>(out, action.amount);
+    put<int32_t>(out, action.option);
+}
+
+void putEndGame(string& out, uint32_t tag, uint32_t session) {
+    putHeader(out, MSG_END_GAME, END_GAME_PAYLOAD);
+    put<uint32_t>(out, tag);
+    put<uint32_t>(out, session);
+}
+
+void putStatus(string& out, uint32_t tag, uint32_t session, uint8_t flags, uint8_t outcome,
+    const int values[FIELD_COUNT]) {
+    putHeader(out, MSG_STATUS, STATUS_PAYLOAD);
+    put<uint32_t>(out, tag);
+    put<uint32_t>(out, session);
+    put<uint8_t>(out, flags);
+    put<uint8_t>(out, outcome);
+    for (int f = 0; f < FIELD_COUNT; f++) put<int32_t>(out, values[f]);
+}
+
+void putError(string& out, uint32_t tag, ServerError error) {
+    putHeader(out, MSG_ERROR, ERROR_PAYLOAD);
+    put<uint32_t>(out, tag);
+    put<uint8_t>(out, error);
+}
+
+bool decodeRequest(const char* frame, ClientRequest& request) {
+    uint8_t type = static_cast<uint8_t>(frame[0]);
+    size_t length = static_cast<uint8_t>(frame[1]);
+    const char* p = frame + FRAME_HEADER;
+    request.type = static_cast<MessageType>(type);
+    request.tag = length >= 4 ? get<uint32_t>(p) : 0;
+    switch (type) {
+    case MSG_NEW_GAME: {
+        if (length != NEW_GAME_PAYLOAD) return false;
+        uint8_t diff = get<uint8_t>(p);
+        if (diff > HARD) return false;
+        request.difficulty = static_cast<Difficulty>(diff);
+        request.seed = get<uint64_t>(p);
+        return true;
+    }
+    case MSG_ACTION: {
+        if (length != ACTION_PAYLOAD) return false;
+        request.session = get<uint32_t>(p);
+        uint8_t action = get<uint8_t>(p);
+        if (action > ACTION_WAIT) return false;
+        request.action.type = static_cast<ActionType>(action);
+        request.action.amount = get<int32_t>(p);
+        request.action.option = get<int32_t>(p);
+        return true;
+    }
+    case MSG_END_GAME: {
+        if (length != END_GAME_PAYLOAD) return false;
+        request.session = get<uint32_t>(p);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool decodeReply(const char* frame, ServerReply& reply) {
+    uint8_t type = static_cast<uint8_t>(frame[0]);
+    size_t length = static_cast<uint8_t>(frame[1]);
+    const char* p = frame + FRAME_HEADER;
+    reply.type = static_cast<MessageType>(type);
+    if (type == MSG_STATUS && length == STATUS_PAYLOAD) {
+        reply.tag = get<uint32_t>(p);
+        reply.session = get<uint32_t>(p);
+        reply.flags = get<uint8_t>(p);
+        reply.outcome = get<uint8_t>(p);
+        for (int f = 0; f < FIELD_COUNT; f++) reply.values[f] = get<int32_t>(p);
+        return true;
+    }
+    if (type == MSG_ERROR && length == ERROR_PAYLOAD) {
+        reply.tag = get<uint32_t>(p);
+        reply.session = 0;
+        reply.flags = get<uint8_t>(p);
+        reply.outcome = 0;
+        return true;
+    }
+    return false;
+}
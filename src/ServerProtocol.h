@@ -0,0 +1,83 @@
+#pragma once
+#include "GameTypes.h"
+#include "StatusRenderer.h"
+
+// Wire format between GameServer and its clients. A frame is a one-byte
+// message type, a one-byte payload length and the payload. Integers are
+// little-endian. Every request carries a tag chosen by the client, which the
+// reply echoes so a client can match replies to requests.
+//
+//   MSG_NEW_GAME  tag u32, difficulty u8, seed u64           -> MSG_STATUS
+//   MSG_ACTION    tag u32, session u32, action u8 (the menu
+//                 number), amount i32, option i32            -> MSG_STATUS
+//   MSG_END_GAME  tag u32, session u32                       (no reply)
+//   MSG_STATUS    tag u32, session u32, flags u8, outcome u8,
+//                 FIELD_COUNT x i32 (see StatusField)
+//   MSG_ERROR     tag u32, error u8
+enum MessageType : uint8_t {
+    MSG_NEW_GAME = 1,
+    MSG_ACTION,
+    MSG_END_GAME,
+    MSG_STATUS,
+    MSG_ERROR
+};
+
+enum ServerError : uint8_t {
+    ERROR_BAD_REQUEST = 1,   // unknown type or wrong payload length
+    ERROR_NO_SESSION,        // the session is not open on this connection
+    ERROR_BUSY               // the server is at its session limit
+};
+
+// MSG_STATUS flags
+const uint8_t STATUS_ACCEPTED = 1;    // the action used up the turn
+const uint8_t STATUS_GAME_OVER = 2;
+
+const size_t FRAME_HEADER = 2;
+const size_t NEW_GAME_PAYLOAD = 13;
+const size_t ACTION_PAYLOAD = 17;
+const size_t END_GAME_PAYLOAD = 8;
+const size_t STATUS_PAYLOAD = 10 + 4 * FIELD_COUNT;
+const size_t ERROR_PAYLOAD = 5;
+const size_t MAX_FRAME = FRAME_HEADER + 255;
+
+static_assert(STATUS_PAYLOAD <= 255, "status must fit one frame");
+
+// A decoded client message
+struct ClientRequest {
+    MessageType type;
+    uint32_t tag;
+    uint32_t session;
+    Difficulty difficulty;
+    uint64_t seed;
+    PlayerAction action;
+};
+
+// A decoded MSG_STATUS or MSG_ERROR
+struct ServerReply {
+    MessageType type;
+    uint32_t tag;
+    uint32_t session;
+    uint8_t flags;     // error code for MSG_ERROR
+    uint8_t outcome;
+    int32_t values[FIELD_COUNT];
+};
+
+// Each put* appends one whole frame
+void putNewGame(string& out, uint32_t tag, Difficulty diff, uint64_t seed);
+void putAction(string& out, uint32_t tag, uint32_t session, const PlayerAction& action);
+void putEndGame(string& out, uint32_t tag, uint32_t session);
+void putStatus(string& out, uint32_t tag, uint32_t session, uint8_t flags, uint8_t outcome,
+    const int values[FIELD_COUNT]);
+void putError(string& out, uint32_t tag, ServerError error);
+
+// Size of the complete frame at data, or 0 if more bytes are needed
+inline size_t frameSize(const char* data, size_t available) {
+    if (available < FRAME_HEADER) return 0;
+    size_t size = FRAME_HEADER + static_cast<uint8_t>(data[1]);
+    return size <= available ? size : 0;
+}
+
+// Decode one complete frame; false if it is not a well-formed message of
+// the expected direction
+bool decodeRequest(const char* frame, ClientRequest& request);
+bool decodeReply(const char* frame, ServerReply& reply);
@@ -0,0 +1,139 @@
+#include "StatusRenderer.h"
+#include "Kingdom.h"
+#include <cmath>
+#include <cstdio>
+
+// Bit set when the king's name changed; names are compared, not counted
+static const uint32_t KING_BIT = 1u << FIELD_COUNT;
+
+static uint32_t bit(StatusField field) {
+    return 1u << field;
+}
+
+// Fields each panel line shows; the rule has none and is drawn only on a
+// full redraw
+static const uint32_t LINE_FIELDS[STATUS_LINES] = {
+    bit(FIELD_TURN),
+    KING_BIT,
+    bit(FIELD_TAX),
+    bit(FIELD_POPULATION),
+    bit(FIELD_HAPPINESS),
+    bit(FIELD_FOOD),
+    bit(FIELD_GOLD),
+    bit(FIELD_WOOD) | bit(FIELD_STONE) | bit(FIELD_IRON) | bit(FIELD_WEAPONS),
+    bit(FIELD_SOLDIERS) | bit(FIELD_MORALE),
+    bit(FIELD_FARMS) | bit(FIELD_BARRACKS),
+    bit(FIELD_DEBT) | bit(FIELD_LOANS) | bit(FIELD_TRUST),
+    0,
+};
+
+StatusRenderer::StatusRenderer(ostream& output) : out(output), drawn(false), lastLinesWritten(0) {
+    for (int i = 0; i < FIELD_COUNT; i++) values[i] = 0;
+    for (int i = 0; i < STATUS_LINES; i++) lines[i][0] = '\0';
+    frame.reserve(STATUS_LINES * (STATUS_LINE_LENGTH + 16) + 32);
+}
+
+StatusRenderer::~StatusRenderer() {
+    if (!drawn) return;
+    // Resetting the region homes the cursor, so keep it where it was
+    out << "\x1b" "7" "\x1b[r" "\x1b" "8";
+    out.flush();
+}
+
+void StatusRenderer::formatLine(int line) {
+    char* text = lines[line];
+    size_t size = STATUS_LINE_LENGTH;
+    const int* v = values;
+    switch (line) {
+    case 0: snprintf(text, size, "=== KINGDOM STATUS (Turn %d) ===", v[FIELD_TURN]); break;
+    case 1: snprintf(text, size, "King: %s", king.c_str()); break;
+    case 2: snprintf(text, size, "Tax: %d%%", v[FIELD_TAX]); break;
+    case 3: snprintf(text, size, "Population: %d", v[FIELD_POPULATION]); break;
+    case 4: snprintf(text, size, "Happiness: %d%%", v[FIELD_HAPPINESS]); break;
+    case 5: snprintf(text, size, "Food: %d", v[FIELD_FOOD]); break;
+    case 6: snprintf(text, size, "Gold: %d", v[FIELD_GOLD]); break;
+    case 7:
+        snprintf(text, size, "Resources: Wood=%d Stone=%d Iron=%d Weapons=%d",
+            v[FIELD_WOOD], v[FIELD_STONE], v[FIELD_IRON], v[FIELD_WEAPONS]);
+        break;
+    case 8: snprintf(text, size, "Army: %d soldiers (Morale: %d%%)", v[FIELD_SOLDIERS], v[FIELD_MORALE]); break;
+    case 9: snprintf(text, size, "Buildings: Farms=%d Barracks=%d", v[FIELD_FARMS], v[FIELD_BARRACKS]); break;
+    case 10:
+        if (v[FIELD_LOANS] == 0) {
+            snprintf(text, size, "Debt: none (Trust: %d%%)", v[FIELD_TRUST]);
+        }
+        else {
+            snprintf(text, size, "Debt: %d gold over %d loans (Trust: %d%%)",
+                v[FIELD_DEBT], v[FIELD_LOANS], v[FIELD_TRUST]);
+        }
+        break;
+    default: snprintf(text, size, "------------------------------------"); break;
+    }
+}
+
+void captureStatus(const Kingdom& kingdom, int values[FIELD_COUNT]) {
+    const LoanLedger& loans = kingdom.bank.getLoans();
+    values[FIELD_TURN] = kingdom.turn;
+    values[FIELD_TAX] = kingdom.currentKing.taxRate;
+    values[FIELD_POPULATION] = kingdom.population.getTotal();
+    values[FIELD_HAPPINESS] = kingdom.population.getHappiness();
+    values[FIELD_FOOD] = kingdom.food.get();
+    values[FIELD_GOLD] = kingdom.gold.get();
+    values[FIELD_WOOD] = kingdom.wood.get();
+    values[FIELD_STONE] = kingdom.stone.get();
+    values[FIELD_IRON] = kingdom.iron.get();
+    values[FIELD_WEAPONS] = kingdom.weapons.get();
+    values[FIELD_SOLDIERS] = kingdom.army.getSoldiers();
+    values[FIELD_MORALE] = kingdom.army.getMorale();
+    values[FIELD_FARMS] = kingdom.buildings.getFarms();
+    values[FIELD_BARRACKS] = kingdom.buildings.getBarracks();
+    values[FIELD_DEBT] = static_cast<int>(ceil(loans.outstanding()));
+    values[FIELD_LOANS] = loans.activeCount();
+    values[FIELD_TRUST] = static_cast<int>(kingdom.bank.getTrustRate() * 100 + 0.5f);
+}
+
+void StatusRenderer::render(const Kingdom& kingdom) {
+    int now[FIELD_COUNT];
+    captureStatus(kingdom, now);
+
+    uint32_t dirty = 0;
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        if (!drawn || now[f] != values[f]) dirty |= 1u << f;
+        values[f] = now[f];
+    }
+    if (!drawn || !(kingdom.currentKing.name == king)) {
+        dirty |= KING_BIT;
+        king = kingdom.currentKing.name;
+    }
+
+    frame.clear();
+    char move[16];
+    int written = 0;
+    // A full redraw clears the screen; an update saves and restores the
+    // cursor so typing below the panel carries on where it was
+    frame += drawn ? "\x1b" "7" : "\x1b[2J";
+    for (int line = 0; line < STATUS_LINES; line++) {
+        if (drawn && (LINE_FIELDS[line] & dirty) == 0) continue;
+        formatLine(line);
+        snprintf(move, sizeof(move), "\x1b[%d;1H", line + 1);
+        frame += move;
+        frame += lines[line];
+        frame += "\x1b[K";
+        written++;
+    }
+    if (drawn) {
+        frame += "\x1b" "8";
+    }
+    else {
+        // Everything below the panel scrolls on its own
+        snprintf(move, sizeof(move), "\x1b[%d;r", STATUS_LINES + 1);
+        frame += move;
+        snprintf(move, sizeof(move), "\x1b[%d;1H", STATUS_LINES + 1);
+        frame += move;
+        drawn = true;
+    }
+    lastLinesWritten = written;
+    if (written == 0) return;
+    out.write(frame.data(), frame.size());
+    out.flush();
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "GameTypes.h"
+#include "FixedName.h"
+
+class Kingdom;
+
+// Kingdom values shown on the status panel
+enum StatusField {
+    FIELD_TURN,
+    FIELD_TAX,
+    FIELD_POPULATION,
+    FIELD_HAPPINESS,
+    FIELD_FOOD,
+    FIELD_GOLD,
+    FIELD_WOOD,
+    FIELD_STONE,
+    FIELD_IRON,
+    FIELD_WEAPONS,
+    FIELD_SOLDIERS,
+    FIELD_MORALE,
+    FIELD_FARMS,
+    FIELD_BARRACKS,
+    FIELD_DEBT,
+    FIELD_LOANS,
+    FIELD_TRUST,
+    FIELD_COUNT
+};
+
+// Reads every status field of a kingdom; the panel and the game server's
+// status message show the same values
+void captureStatus(const Kingdom& kingdom, int values[FIELD_COUNT]);
+
+const int STATUS_LINES = 12;
+const int STATUS_LINE_LENGTH = 96;
+
+// Draws the kingdom status as a panel pinned to the top of an ANSI terminal,
+// replacing the clear-and-reprint of Kingdom::showStatus for interactive
+// play. The rows below the panel are set as the scrolling region, so menus
+// and narration scroll underneath it. Each frame compares the kingdom's
+// values with the previous frame, reformats only the lines whose fields
+// changed, and sends them with cursor moves in one buffered write. There is
+// no sleep and no subprocess.
+class StatusRenderer {
+private:
+    ostream& out;
+    int values[FIELD_COUNT];
+    Name king;
+    char lines[STATUS_LINES][STATUS_LINE_LENGTH];
+    string frame;
+    bool drawn;
+    int lastLinesWritten;
+
+    void formatLine(int line);
+
+public:
+    explicit StatusRenderer(ostream& output);
+
+    // Restores the full-screen scrolling region
+    ~StatusRenderer();
+
+    // Brings the panel up to date with the kingdom; the first frame clears
+    // the screen and draws every line
+    void render(const Kingdom& kingdom);
+
+    // Forces the next frame to redraw everything (after a resize, say)
+    void invalidate() {
+        drawn = false;
+    }
+
+    // Lines sent by the last render call
+    int linesWritten() const {
+        return lastLinesWritten;
+    }
+};
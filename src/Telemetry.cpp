@@ -0,0 +1,240 @@
+#include "Telemetry.h"
+#include "Kingdom.h"
+#include "Varint.h"
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TELEMETRY_SIMD 1
+#endif
+
+static const char TELEMETRY_MAGIC[6] = { 'S', 'H', 'T', 'E', 'L', '2' };
+
+// Deltas are packed in blocks of this many, each at the bit width of its
+// largest value. A block is four interleaved lanes (value i goes to lane
+// i % 4), so a width of w bits takes exactly 4w words, and SSE2 packs the
+// four lanes at once.
+static const size_t PACK_BLOCK = 128;
+static const size_t PACK_LANES = 4;
+
+// Packs a full block of values below 2^width; returns the end of its
+// 16 * width bytes
+static uint8_t* pack(const uint32_t* values, unsigned width, uint8_t* out) {
+    unsigned bits = 0;
+#ifdef TELEMETRY_SIMD
+    __m128i pending = _mm_setzero_si128();
+    for (size_t k = 0; k < PACK_BLOCK; k += PACK_LANES) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + k));
+        pending = _mm_or_si128(pending, _mm_sll_epi32(v, _mm_cvtsi32_si128(bits)));
+        bits += width;
+        if (bits >= 32) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), pending);
+            out += 16;
+            bits -= 32;
+            // Shifts of 32 or more give zero
+            pending = _mm_srl_epi32(v, _mm_cvtsi32_si128(width - bits));
+        }
+    }
+#else
+    uint32_t pending[PACK_LANES] = {};
+    for (size_t k = 0; k < PACK_BLOCK; k += PACK_LANES) {
+        for (size_t l = 0; l < PACK_LANES; l++) pending[l] |= values[k + l] << bits;
+        bits += width;
+        if (bits >= 32) {
+            memcpy(out, pending, sizeof(pending));
+            out += sizeof(pending);
+            bits -= 32;
+            for (size_t l = 0; l < PACK_LANES; l++) pending[l] = bits > 0 ? values[k + l] >> (width - bits) : 0;
+        }
+    }
+#endif
+    return out;
+}
+
+// Reverses pack() for the 16 * width bytes at data
+static void unpack(const uint8_t* data, unsigned width, uint32_t* values) {
+    uint64_t mask = (uint64_t(1) << width) - 1;
+    for (size_t l = 0; l < PACK_LANES; l++) {
+        const uint8_t* next = data + l * 4;
+        uint64_t pending = 0;
+        unsigned bits = 0;
+        for (size_t k = 0; k < PACK_BLOCK; k += PACK_LANES) {
+            if (bits < width) {
+                uint32_t word;
+                memcpy(&word, next, sizeof(word));
+                next += PACK_LANES * 4;
+                pending |= static_cast<uint64_t>(word) << bits;
+                bits += 32;
+            }
+            values[k + l] = static_cast<uint32_t>(pending & mask);
+            pending >>= width;
+            bits -= width;
+        }
+    }
+}
+
+const char* telemetryColumnName(TelemetryColumn column) {
+    switch (column) {
+    case TEL_GAME: return "game";
+    case TEL_TURN: return "turn";
+    case TEL_FOOD: return "food";
+    case TEL_GOLD: return "gold";
+    case TEL_WOOD: return "wood";
+    case TEL_STONE: return "stone";
+    case TEL_IRON: return "iron";
+    case TEL_WEAPONS: return "weapons";
+    case TEL_PEASANTS: return "peasants";
+    case TEL_MERCHANTS: return "merchants";
+    case TEL_NOBILITY: return "nobility";
+    case TEL_POP_SOLDIERS: return "pop_soldiers";
+    case TEL_HAPPINESS: return "happiness";
+    case TEL_ARMY: return "army_soldiers";
+    case TEL_MORALE: return "morale";
+    case TEL_FOOD_PRICE: return "food_price";
+    case TEL_WEAPON_PRICE: return "weapon_price";
+    case TEL_EVENT: return "event";
+    case TEL_OUTCOME: return "outcome";
+    default: return "unknown";
+    }
+}
+
+void TelemetryChunk::append(uint32_t game, const Kingdom& kingdom) {
+    int32_t* row = values[rows++];
+    row[TEL_GAME] = static_cast<int32_t>(game);
+    row[TEL_TURN] = kingdom.turn;
+    row[TEL_FOOD] = kingdom.food.get();
+    row[TEL_GOLD] = kingdom.gold.get();
+    row[TEL_WOOD] = kingdom.wood.get();
+    row[TEL_STONE] = kingdom.stone.get();
+    row[TEL_IRON] = kingdom.iron.get();
+    row[TEL_WEAPONS] = kingdom.weapons.get();
+    row[TEL_PEASANTS] = kingdom.population.getPeasants();
+    row[TEL_MERCHANTS] = kingdom.population.getMerchants();
+    row[TEL_NOBILITY] = kingdom.population.getNobility();
+    row[TEL_POP_SOLDIERS] = kingdom.population.getSoldiers();
+    row[TEL_HAPPINESS] = kingdom.population.getHappiness();
+    row[TEL_ARMY] = kingdom.army.getSoldiers();
+    row[TEL_MORALE] = kingdom.army.getMorale();
+    row[TEL_FOOD_PRICE] = kingdom.market.getFoodPrice();
+    row[TEL_WEAPON_PRICE] = kingdom.market.getWeaponPrice();
+    row[TEL_EVENT] = kingdom.lastEvent;
+    row[TEL_OUTCOME] = kingdom.getOutcome();
+}
+
+TelemetryWriter::TelemetryWriter(size_t chunkLimit) : ChunkWriter(chunkLimit), rows(0), bytes(0) {}
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+bool TelemetryWriter::open(const string& path) {
+    if (!create(path)) return false;
+    string header(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+    putVarint(header, TELEMETRY_COLUMNS);
+    for (int c = 0; c < TELEMETRY_COLUMNS; c++) {
+        const char* name = telemetryColumnName(static_cast<TelemetryColumn>(c));
+        header.push_back(static_cast<char>(strlen(name)));
+        header += name;
+    }
+    file.write(header.data(), header.size());
+    rows.store(0, memory_order_relaxed);
+    bytes.store(header.size(), memory_order_relaxed);
+    start();
+    return true;
+}
+
+void TelemetryWriter::encode(const TelemetryChunk& chunk) {
+    static const int32_t NO_ROW[TELEMETRY_COLUMNS] = {};
+    size_t count = chunk.rows;
+    size_t blocks = (count + PACK_BLOCK - 1) / PACK_BLOCK;
+    // A width byte and at most 4 bytes a value per block
+    size_t room = blocks * (1 + PACK_BLOCK * 4);
+    column.resize(room * TELEMETRY_COLUMNS);
+    uint8_t* out[TELEMETRY_COLUMNS];
+    for (int c = 0; c < TELEMETRY_COLUMNS; c++) out[c] = column.data() + c * room;
+
+    // Rows are turned into columns a block at a time, in a buffer small
+    // enough to stay in L1; the padding past the last row packs as zeros
+    uint32_t tile[TELEMETRY_COLUMNS][PACK_BLOCK];
+    for (size_t first = 0; first < count; first += PACK_BLOCK) {
+        size_t n = count - first < PACK_BLOCK ? count - first : PACK_BLOCK;
+        if (n < PACK_BLOCK) memset(tile, 0, sizeof(tile));
+        for (size_t i = 0; i < n; i++) {
+            const int32_t* row = chunk.values[first + i];
+            const int32_t* previous = first + i > 0 ? chunk.values[first + i - 1] : NO_ROW;
+            for (int c = 0; c < TELEMETRY_COLUMNS; c++) {
+                tile[c][i] = zigzag(static_cast<int32_t>(static_cast<uint32_t>(row[c]) - static_cast<uint32_t>(previous[c])));
+            }
+        }
+        for (int c = 0; c < TELEMETRY_COLUMNS; c++) {
+            uint32_t any = 0;
+            for (size_t i = 0; i < PACK_BLOCK; i++) any |= tile[c][i];
+            unsigned width = 0;
+            while (width < 32 && (any >> width) != 0) width++;
+            *out[c]++ = static_cast<uint8_t>(width);
+            out[c] = pack(tile[c], width, out[c]);
+        }
+    }
+
+    encoded.clear();
+    putVarint(encoded, count);
+    for (int c = 0; c < TELEMETRY_COLUMNS; c++) {
+        const uint8_t* begin = column.data() + c * room;
+        putVarint(encoded, static_cast<uint64_t>(out[c] - begin));
+        encoded.append(reinterpret_cast<const char*>(begin), out[c] - begin);
+    }
+}
+
+void TelemetryWriter::write(const TelemetryChunk& chunk) {
+    encode(chunk);
+    file.write(encoded.data(), encoded.size());
+    rows.fetch_add(chunk.rows, memory_order_relaxed);
+    bytes.fetch_add(encoded.size(), memory_order_relaxed);
+}
+
+bool TelemetryWriter::load(const string& path, vector<vector<int32_t>>& columns) {
+    ifstream in(path, ios::binary);
+    char magic[sizeof(TELEMETRY_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, TELEMETRY_MAGIC, sizeof(magic)) != 0) return false;
+    uint64_t count;
+    if (!getVarint(in, count) || count == 0 || count > 1024) return false;
+    for (uint64_t c = 0; c < count; c++) {
+        int length = in.get();
+        if (length == EOF || !in.ignore(length)) return false;
+    }
+    columns.assign(count, vector<int32_t>());
+
+    string block;
+    vector<uint32_t> deltas(PACK_BLOCK);
+    uint64_t blockRows;
+    while (getVarint(in, blockRows)) {
+        if (blockRows > TELEMETRY_CHUNK_ROWS) return true;
+        // Decode the whole block before keeping any of it
+        vector<vector<int32_t>> decoded(count);
+        for (uint64_t c = 0; c < count; c++) {
+            uint64_t length;
+            if (!getVarint(in, length)) return true;
+            block.resize(length);
+            if (length > 0 && !in.read(&block[0], length)) return true;
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(block.data());
+            const uint8_t* end = p + length;
+            uint32_t value = 0;
+            decoded[c].resize(blockRows);
+            for (uint64_t first = 0; first < blockRows; first += PACK_BLOCK) {
+                if (p == end || *p > 32) return true;
+                unsigned width = *p++;
+                if (static_cast<size_t>(end - p) < width * 16u) return true;
+                unpack(p, width, deltas.data());
+                p += width * 16;
+                size_t n = static_cast<size_t>(blockRows - first < PACK_BLOCK ? blockRows - first : PACK_BLOCK);
+                for (size_t i = 0; i < n; i++) {
+                    value += static_cast<uint32_t>(unzigzag(deltas[i]));
+                    decoded[c][first + i] = static_cast<int32_t>(value);
+                }
+            }
+        }
+        for (uint64_t c = 0; c < count; c++) {
+            columns[c].insert(columns[c].end(), decoded[c].begin(), decoded[c].end());
+        }
+    }
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "GameTypes.h"
+#include "ChunkWriter.h"
+#include <atomic>
+
+class Kingdom;
+
+// One column per value recorded after every turn of every game
+enum TelemetryColumn {
+    TEL_GAME,
+    TEL_TURN,
+    TEL_FOOD,
+    TEL_GOLD,
+    TEL_WOOD,
+    TEL_STONE,
+    TEL_IRON,
+    TEL_WEAPONS,
+    TEL_PEASANTS,
+    TEL_MERCHANTS,
+    TEL_NOBILITY,
+    TEL_POP_SOLDIERS,
+    TEL_HAPPINESS,
+    TEL_ARMY,
+    TEL_MORALE,
+    TEL_FOOD_PRICE,
+    TEL_WEAPON_PRICE,
+    TEL_EVENT,     // id of the random event fired that turn, -1 if none
+    TEL_OUTCOME,   // GameOutcome; in_progress until the game's last turn
+    TELEMETRY_COLUMNS
+};
+
+const char* telemetryColumnName(TelemetryColumn column);
+
+const size_t TELEMETRY_CHUNK_ROWS = 8192;
+
+// A block of turn rows. Workers fill it one contiguous row at a time, which
+// touches two cache lines per turn where writing straight into 19 column
+// arrays would touch 19; the writer thread splits it into columns.
+struct TelemetryChunk {
+    int32_t values[TELEMETRY_CHUNK_ROWS][TELEMETRY_COLUMNS];
+    size_t rows;
+
+    TelemetryChunk() : rows(0) {}
+
+    bool full() const {
+        return rows == TELEMETRY_CHUNK_ROWS;
+    }
+
+    bool empty() const {
+        return rows == 0;
+    }
+
+    void clear() {
+        rows = 0;
+    }
+
+    // Records the state of game `game` at the end of its latest turn
+    void append(uint32_t game, const Kingdom& kingdom);
+};
+
+// Writes telemetry chunks to a columnar file on a background thread.
+//
+// File layout: "SHTEL2", a varint column count and the column names (a
+// length byte and the characters), then one block per chunk: a varint row
+// count and, for each column, a varint byte length followed by the column's
+// values as zigzag differences from the previous row. The differences are
+// bit-packed 128 rows at a time (the last block padded with zeros): a width
+// byte w, then 4w little-endian words in which value i is lane i % 4 and
+// each lane holds its values in w bits apiece, low bits first. Turn rows
+// change little from one to the next, so most values take a few bits, and
+// packing needs none of a varint's per-value branches.
+//
+// Chunks are queued and recycled by ChunkWriter. Row order across chunks
+// depends on thread timing, so readers should key rows by game and turn.
+class TelemetryWriter : public ChunkWriter<TelemetryChunk> {
+private:
+    atomic<uint64_t> rows;    // updated by the writer thread
+    atomic<uint64_t> bytes;
+    string encoded;
+    vector<uint8_t> column;    // each column's packed blocks, before they are joined
+
+    void encode(const TelemetryChunk& chunk);
+
+protected:
+    void write(const TelemetryChunk& chunk) override;
+
+public:
+    explicit TelemetryWriter(size_t chunkLimit = 16);
+    ~TelemetryWriter();
+
+    // Creates the file, writes the header and starts the writer thread
+    bool open(const string& path);
+
+    // Totals so far; safe to read while writing, exact once close() has
+    // returned
+    uint64_t rowsWritten() const {
+        return rows.load(memory_order_relaxed);
+    }
+
+    uint64_t bytesWritten() const {
+        return bytes.load(memory_order_relaxed);
+    }
+
+    // Reads a telemetry file back into one vector per column. A truncated
+    // last block (e.g. after a crash) is dropped.
+    static bool load(const string& path, vector<vector<int32_t>>& columns);
+};
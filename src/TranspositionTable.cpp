@@ -0,0 +1,48 @@
+#include "TranspositionTable.h"
+#include <cstring>
+
+static uint64_t pack(const CachedValue& value) {
+    uint32_t total;
+    memcpy(&total, &value.total, sizeof(total));
+    return (static_cast<uint64_t>(value.samples) << 32) | total;
+}
+
+static CachedValue unpack(uint64_t bits) {
+    CachedValue value;
+    uint32_t total = static_cast<uint32_t>(bits);
+    memcpy(&value.total, &total, sizeof(total));
+    value.samples = static_cast<uint32_t>(bits >> 32);
+    return value;
+}
+
+TranspositionTable::TranspositionTable(size_t slotCount) {
+    size_t size = 1;
+    while (size < slotCount) size <<= 1;
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+    clear();
+}
+
+bool TranspositionTable::find(uint64_t key, CachedValue& value) const {
+    const Slot& slot = slots[key & mask];
+    uint64_t payload = slot.payload.load(memory_order_relaxed);
+    uint64_t check = slot.check.load(memory_order_relaxed);
+    // An empty slot has no samples, so it never passes for a position
+    if ((check ^ payload) != key || payload >> 32 == 0) return false;
+    value = unpack(payload);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, const CachedValue& value) {
+    Slot& slot = slots[key & mask];
+    uint64_t payload = pack(value);
+    slot.payload.store(payload, memory_order_relaxed);
+    slot.check.store(key ^ payload, memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; i++) {
+        slots[i].check.store(0, memory_order_relaxed);
+        slots[i].payload.store(0, memory_order_relaxed);
+    }
+}
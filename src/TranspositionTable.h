@@ -0,0 +1,55 @@
+#pragma once
+#include "GameTypes.h"
+#include <atomic>
+#include <memory>
+
+// What the table knows about a position: the sum of `samples` evaluations
+struct CachedValue {
+    float total;
+    uint32_t samples;
+
+    CachedValue() : total(0.0f), samples(0) {}
+
+    double mean() const {
+        return samples ? total / samples : 0.0;
+    }
+};
+
+// Fixed-size cache of evaluated positions keyed by Kingdom::hash(), shared
+// by every search thread without locks. A slot holds a 64-bit payload and
+// the key XORed with that payload, as two relaxed atomics. A reader that
+// catches a slot halfway through a write sees a key that does not match,
+// and treats it as a miss. Slots are direct-mapped, and a store replaces
+// whatever position was there, so the table never grows. Two threads
+// updating one position at once may lose a sample; that only costs an
+// extra simulation later. Keys do not cover the rules a game is played
+// under, so one table must only serve games with the same BalanceParams and
+// EventTable.
+class TranspositionTable {
+private:
+    struct Slot {
+        atomic<uint64_t> check;     // key ^ payload
+        atomic<uint64_t> payload;   // CachedValue bits
+    };
+
+    unique_ptr<Slot[]> slots;
+    size_t mask;
+
+public:
+    // slotCount is rounded up to a power of two
+    explicit TranspositionTable(size_t slotCount);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    size_t size() const {
+        return mask + 1;
+    }
+
+    // False if the position is not in the table
+    bool find(uint64_t key, CachedValue& value) const;
+
+    void store(uint64_t key, const CachedValue& value);
+
+    void clear();
+};
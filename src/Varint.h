@@ -0,0 +1,67 @@
+#pragma once
+#include "GameTypes.h"
+
+// LEB128 varints and the zigzag mapping used by the binary formats (action
+// logs, telemetry and checkpoints): seven bits per byte, low bits first, the
+// high bit set on every byte but the last. Zigzag folds signed values so
+// small magnitudes of either sign take one byte.
+
+inline void putVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline void putVarint(ostream& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+// Writes to a buffer the caller has sized (at most 10 bytes per value) and
+// returns the end of what was written
+inline uint8_t* putVarint(uint8_t* out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+// False if the input ends before the value does
+inline bool getVarint(const char*& p, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline bool getVarint(istream& in, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Differences are taken in 32-bit wrapping arithmetic, so any pair of
+// values round-trips
+inline uint32_t zigzag(int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline int32_t unzigzag(uint64_t v) {
+    uint32_t u = static_cast<uint32_t>(v);
+    return static_cast<int32_t>((u >> 1) ^ (0u - (u & 1)));
+}
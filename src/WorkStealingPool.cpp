@@ -0,0 +1,92 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) :
+    job(nullptr), generation(0), activeWorkers(0), stopping(false) {
+    if (threadCount == 0) threadCount = thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    for (unsigned i = 0; i < threadCount; i++) {
+        queues.push_back(unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    for (unsigned i = 1; i < threadCount; i++) {
+        threads.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(jobLock);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+bool WorkStealingPool::takeChunk(unsigned worker, pair<size_t, size_t>& chunk) {
+    {
+        WorkerQueue& own = *queues[worker];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.back();
+            own.chunks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); i++) {
+        WorkerQueue& victim = *queues[(worker + i) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::drain(unsigned worker) {
+    pair<size_t, size_t> chunk;
+    while (takeChunk(worker, chunk)) {
+        (*job)(worker, chunk.first, chunk.second);
+    }
+}
+
+void WorkStealingPool::workerLoop(unsigned worker) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(jobLock);
+            jobReady.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        drain(worker);
+        {
+            lock_guard<mutex> guard(jobLock);
+            activeWorkers--;
+        }
+        jobDone.notify_one();
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t count, size_t grain, const Job& body) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    size_t chunkIndex = 0;
+    for (size_t begin = 0; begin < count; begin += grain, chunkIndex++) {
+        size_t end = begin + grain < count ? begin + grain : count;
+        queues[chunkIndex % queues.size()]->chunks.push_back(make_pair(begin, end));
+    }
+    {
+        lock_guard<mutex> guard(jobLock);
+        job = &body;
+        activeWorkers = static_cast<unsigned>(threads.size());
+        generation++;
+    }
+    jobReady.notify_all();
+    drain(0);
+    unique_lock<mutex> guard(jobLock);
+    jobDone.wait(guard, [&] { return activeWorkers == 0; });
+    job = nullptr;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "GameTypes.h"
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+
+// Thread pool for batches of independent jobs. Work is split into chunks that
+// are dealt out to per-worker queues; a worker takes chunks from the back of
+// its own queue and, once that runs dry, steals from the front of the others.
+// The calling thread joins in as worker 0.
+class WorkStealingPool {
+public:
+    typedef function<void(unsigned worker, size_t begin, size_t end)> Job;
+
+private:
+    struct WorkerQueue {
+        mutex lock;
+        deque<pair<size_t, size_t>> chunks;
+    };
+
+    vector<thread> threads;
+    vector<unique_ptr<WorkerQueue>> queues;
+    mutex jobLock;
+    condition_variable jobReady;
+    condition_variable jobDone;
+    const Job* job;
+    uint64_t generation;
+    unsigned activeWorkers;
+    bool stopping;
+
+    bool takeChunk(unsigned worker, pair<size_t, size_t>& chunk);
+    void drain(unsigned worker);
+    void workerLoop(unsigned worker);
+
+public:
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    unsigned size() const {
+        return static_cast<unsigned>(queues.size());
+    }
+
+    // Runs body over [0, count) in chunks of at most grain items and returns
+    // once every chunk has finished. Not reentrant.
+    void parallelFor(size_t count, size_t grain, const Job& body);
+};
@@ -0,0 +1,230 @@
+#include "World.h"
+#include "Narrator.h"
+
+void WorldStats::print(ostream& out) const {
+    out << "Ticks: " << ticks << "  Kingdom turns: " << turns << "\n";
+    out << "Fills: " << trades << " (" << goodsTraded << " goods)  Raids: " << battles
+        << " (" << goldPlundered << " gold plundered)\n";
+}
+
+// Food a kingdom wants in store: three turns of consumption
+static int foodNeed(const Kingdom& kingdom) {
+    return kingdom.population.getTotal() / 2 * 3;
+}
+
+World::World(size_t w, size_t h, Difficulty diff, uint64_t seed, unsigned threads,
+    const PolicyActionSource::Policy& p) :
+    width(w), height(h), intents(w * h), policy(p), pool(threads) {
+    kingdoms.reserve(w * h);
+    policyRngs.reserve(w * h);
+    for (size_t i = 0; i < w * h; i++) {
+        kingdoms.push_back(Kingdom(diff, Random::mixSeed(seed, i)));
+        policyRngs.push_back(Random(~Random::mixSeed(seed, i)));
+    }
+    for (int c = 0; c < COMMODITY_COUNT; c++) {
+        orderIds[c].resize(w * h);
+    }
+    for (unsigned t = 0; t < pool.size(); t++) {
+        fields.push_back(unique_ptr<Battlefield>(new Battlefield(1)));
+    }
+}
+
+size_t World::neighbor(size_t i, int slot) const {
+    size_t x = i % width;
+    size_t y = i / width;
+    switch (slot) {
+    case 0: x = (x + width - 1) % width; break;
+    case 1: x = (x + 1) % width; break;
+    case 2: y = (y + height - 1) % height; break;
+    default: y = (y + 1) % height; break;
+    }
+    return y * width + x;
+}
+
+size_t World::aliveCount() const {
+    size_t alive = 0;
+    for (size_t i = 0; i < kingdoms.size(); i++) {
+        if (!kingdoms[i].isGameOver()) alive++;
+    }
+    return alive;
+}
+
+// Stock a kingdom wants to hold of each commodity
+static int stockTarget(const Kingdom& kingdom, Commodity commodity) {
+    switch (commodity) {
+    case COMMODITY_FOOD: return foodNeed(kingdom);
+    case COMMODITY_WEAPONS: return kingdom.army.getSoldiers();
+    // Enough for a farm and a barracks
+    case COMMODITY_WOOD: return kingdom.getBalance().farmWoodCost + kingdom.getBalance().barracksWoodCost;
+    case COMMODITY_STONE: return kingdom.getBalance().farmStoneCost + kingdom.getBalance().barracksStoneCost;
+    default: return 0;                // iron has no use yet
+    }
+}
+
+static const uint32_t NO_ORDER = 0xFFFFFFFFu;
+
+void World::compute(size_t i, Battlefield& field) {
+    const Kingdom& self = kingdoms[i];
+    Intent& intent = intents[i];
+    intent.raidTarget = -1;
+    for (int c = 0; c < COMMODITY_COUNT; c++) intent.orders[c].quantity = 0;
+    if (self.isGameOver()) return;
+
+    intent.action = policy(self, policyRngs[i]);
+
+    // Bids may spend half of the gold the kingdom starts the tick with and
+    // raids against it can take at most the other half, so every charge in
+    // the commit phase is affordable.
+    int gold = self.gold.get() > 0 ? self.gold.get() : 0;
+    int budget = gold / 2;
+
+    // Buy up to the target at a premium, offer half of anything well beyond
+    // it at the kingdom's own reference price
+    for (int c = 0; c < COMMODITY_COUNT; c++) {
+        Commodity commodity = static_cast<Commodity>(c);
+        WorldOrder& order = intent.orders[c];
+        int have = self.stock(commodity).get();
+        int target = stockTarget(self, commodity);
+        int price = self.market.getPrice(commodity);
+        if (have < target) {
+            order.side = SIDE_BUY;
+            order.price = price + 1;
+            order.quantity = min(target - have, budget / order.price);
+            budget -= order.quantity * order.price;
+        }
+        else if (have > target * 3 / 2 + 10) {
+            order.side = SIDE_SELL;
+            order.price = price;
+            order.quantity = (have - target) / 2;
+        }
+    }
+
+    bool canRaid = self.turn - self.lastWarTurn >= 3 && self.army.getMorale() >= 60
+        && self.army.getSoldiers() >= 20;
+    int weakest = self.army.getSoldiers() * 2 / 3;
+    for (int s = 0; canRaid && s < WORLD_NEIGHBORS; s++) {
+        size_t n = neighbor(i, s);
+        const Kingdom& other = kingdoms[n];
+        if (n == i || other.isGameOver()) continue;
+        if (other.army.getSoldiers() < weakest) {
+            weakest = other.army.getSoldiers();
+            intent.raidTarget = static_cast<int32_t>(n);
+            intent.raidGold = other.gold.get() > 0 ? other.gold.get() / (2 * WORLD_NEIGHBORS) : 0;
+        }
+    }
+    if (intent.raidTarget >= 0) {
+        // The battle only depends on the start-of-tick armies and its seed,
+        // so it is fought here and its losses applied by both sides in commit
+        const Kingdom& other = kingdoms[intent.raidTarget];
+        Army raider = self.army;
+        Army defender = other.army;
+        intent.raid = raider.battle(field, self.weapons, defender, other.weapons.get(),
+            Random::mixSeed(self.rng.getSeed(), self.turn));
+    }
+}
+
+void World::clear(Commodity commodity) {
+    OrderBook& book = exchange.book(commodity);
+    vector<uint32_t>& ids = orderIds[commodity];
+    book.reset();
+    int64_t priceSum = 0;
+    for (size_t i = 0; i < kingdoms.size(); i++) {
+        const WorldOrder& order = intents[i].orders[commodity];
+        ids[i] = NO_ORDER;
+        if (order.quantity <= 0) continue;
+        ids[i] = book.submit(order.side, static_cast<uint32_t>(i), order.price, order.quantity);
+        priceSum += order.price;
+    }
+    // Ties between equally good clearing prices go to the mean limit price
+    int32_t reference = book.size() > 0 ? static_cast<int32_t>(priceSum / static_cast<int64_t>(book.size())) : 1;
+    book.clear(reference);
+}
+
+void World::commit(size_t i, WorldStats& stats) {
+    Kingdom& self = kingdoms[i];
+    const Intent& own = intents[i];
+    if (self.isGameOver()) return;
+
+    for (int c = 0; c < COMMODITY_COUNT; c++) {
+        if (orderIds[c][i] == NO_ORDER) continue;
+        Commodity commodity = static_cast<Commodity>(c);
+        const OrderBook& book = exchange.book(commodity);
+        const BookOrder& order = book.order(orderIds[c][i]);
+        if (order.filled == 0) continue;
+        Market::settle(order.side, order.filled, order.filled * book.lastResult().price,
+            self.stock(commodity), self.gold);
+        stats.trades++;
+        stats.goodsTraded += order.filled;
+    }
+
+    for (int s = 0; s < WORLD_NEIGHBORS; s++) {
+        size_t n = neighbor(i, s);
+        // On a grid 2 wide (or high) both sides are the same kingdom, whose
+        // raid must be taken only once
+        if (n == i || (s % 2 == 1 && n == neighbor(i, s - 1))) continue;
+        const Intent& in = intents[n];
+        if (in.raidTarget == static_cast<int32_t>(i)) {
+            self.army.endBattle(in.raid, 1);
+            if (in.raid.winner == 0) self.gold.remove(in.raidGold);
+            self.population.updateHappiness(-10);
+        }
+    }
+
+    if (own.raidTarget >= 0) {
+        self.army.endBattle(own.raid, 0);
+        self.lastWarTurn = self.turn;
+        stats.battles++;
+        if (own.raid.winner == 0) {
+            self.gold.add(own.raidGold);
+            stats.goldPlundered += own.raidGold;
+        }
+    }
+
+    // Where the exchange traded, its price replaces the kingdom's own quote
+    const AuctionResult& food = exchange.book(COMMODITY_FOOD).lastResult();
+    const AuctionResult& arms = exchange.book(COMMODITY_WEAPONS).lastResult();
+    self.market.setPrices(food.volume > 0 ? food.price : self.market.getFoodPrice(),
+        arms.volume > 0 ? arms.price : self.market.getWeaponPrice());
+
+    if (!self.step(own.action) && !self.isGameOver()) {
+        self.step(PlayerAction(ACTION_WAIT));
+    }
+    stats.turns++;
+}
+
+WorldStats World::tick() {
+    vector<WorldStats> perWorker(pool.size());
+
+    pool.parallelFor(kingdoms.size(), 256, [&](unsigned worker, size_t begin, size_t end) {
+        Narrator previous = narrator();
+        narrator().mute();
+        for (size_t i = begin; i < end; i++) compute(i, *fields[worker]);
+        narrator() = previous;
+    });
+
+    pool.parallelFor(COMMODITY_COUNT, 1, [&](unsigned, size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) clear(static_cast<Commodity>(c));
+    });
+
+    pool.parallelFor(kingdoms.size(), 256, [&](unsigned worker, size_t begin, size_t end) {
+        Narrator previous = narrator();
+        narrator().mute();
+        for (size_t i = begin; i < end; i++) commit(i, perWorker[worker]);
+        narrator() = previous;
+    });
+
+    WorldStats total;
+    for (size_t i = 0; i < perWorker.size(); i++) {
+        total.merge(perWorker[i]);
+    }
+    total.ticks = 1;
+    return total;
+}
+
+WorldStats World::run(int maxTicks) {
+    WorldStats total;
+    for (int t = 0; t < maxTicks && aliveCount() > 0; t++) {
+        total.merge(tick());
+    }
+    return total;
+}
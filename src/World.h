@@ -0,0 +1,111 @@
+#pragma once
+#include "GameTypes.h"
+#include "ActionSource.h"
+#include "Kingdom.h"
+#include "WorkStealingPool.h"
+#include "OrderBook.h"
+#include "Battlefield.h"
+#include <memory>
+
+const int WORLD_NEIGHBORS = 4;
+
+// Totals for world ticks. Each worker counts into its own copy, padded to a
+// cache line, and the copies are merged at the end of the tick.
+struct alignas(64) WorldStats {
+    uint64_t ticks;
+    uint64_t turns;
+    uint64_t trades;
+    uint64_t goodsTraded;
+    uint64_t battles;
+    uint64_t goldPlundered;
+
+    WorldStats() : ticks(0), turns(0), trades(0), goodsTraded(0), battles(0), goldPlundered(0) {}
+
+    void merge(const WorldStats& other) {
+        ticks += other.ticks;
+        turns += other.turns;
+        trades += other.trades;
+        goodsTraded += other.goodsTraded;
+        battles += other.battles;
+        goldPlundered += other.goldPlundered;
+    }
+
+    void print(ostream& out) const;
+};
+
+// Many kingdoms on a width x height torus. They trade every commodity on one
+// shared exchange and raid their four grid neighbours. A tick runs in three
+// parallel phases:
+//   compute - every kingdom reads itself and its neighbours (read-only) and
+//             writes only its own intent: its action, its orders and a raid,
+//             whose battle is fought out on copies of the two armies;
+//   clear   - one job per commodity submits the orders in kingdom order and
+//             runs that book's batch auction;
+//   commit  - every kingdom settles its fills, applies the raids aimed at it
+//             and its own raid, adopts the cleared prices, then takes its
+//             turn, writing only its own state.
+// Intents are sized from the start-of-tick state so that everything a kingdom
+// can be charged in one tick is affordable, and incoming raids are applied in
+// neighbour order, so results do not depend on the thread count or schedule.
+class World {
+private:
+    struct WorldOrder {
+        OrderSide side;
+        int32_t price;
+        int32_t quantity;     // 0 for no order
+    };
+
+    struct Intent {
+        PlayerAction action;
+        WorldOrder orders[COMMODITY_COUNT];
+        int32_t raidTarget;   // kingdom index, -1 for none
+        int32_t raidGold;     // plunder if the raid is won
+        BattleResult raid;    // fought in compute on copies of both armies
+    };
+
+    size_t width;
+    size_t height;
+    vector<Kingdom> kingdoms;
+    vector<Random> policyRngs;
+    vector<Intent> intents;
+    Exchange exchange;
+    vector<uint32_t> orderIds[COMMODITY_COUNT];
+    PolicyActionSource::Policy policy;
+    WorkStealingPool pool;
+    vector<unique_ptr<Battlefield>> fields;   // one per worker, single-threaded
+
+    void compute(size_t i, Battlefield& field);
+    void clear(Commodity commodity);
+    void commit(size_t i, WorldStats& stats);
+
+public:
+    World(size_t w, size_t h, Difficulty diff, uint64_t seed, unsigned threads = 0,
+        const PolicyActionSource::Policy& p = randomPolicy);
+
+    size_t size() const {
+        return kingdoms.size();
+    }
+
+    unsigned threadCount() const {
+        return pool.size();
+    }
+
+    const Kingdom& kingdom(size_t i) const {
+        return kingdoms[i];
+    }
+
+    // Grid neighbour `slot` (0-3: west, east, north, south) of kingdom i
+    size_t neighbor(size_t i, int slot) const;
+
+    size_t aliveCount() const;
+
+    // The books as of the last tick's auctions
+    const Exchange& market() const {
+        return exchange;
+    }
+
+    WorldStats tick();
+
+    // Ticks until every kingdom's game is over or maxTicks is reached
+    WorldStats run(int maxTicks);
+};
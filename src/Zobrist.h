@@ -0,0 +1,52 @@
+#pragma once
+#include "GameTypes.h"
+
+// The parts of a kingdom's state that Kingdom::hash() covers. Each value a
+// field can hold is a Zobrist feature with its own key, and a state's hash is
+// the XOR of the keys of its features, so a change to one field updates the
+// hash with two XORs. Values are unbounded, so keys are computed by hashing
+// (field, value) instead of being read from a table.
+enum HashField {
+    HASH_NONE,
+    HASH_TURN,
+    HASH_DIFFICULTY,
+    HASH_OUTCOME,
+    HASH_LAST_DISASTER,
+    HASH_LAST_WAR,
+    HASH_LAST_ELECTION,
+    HASH_TAX_RATE,
+    HASH_FOOD,
+    HASH_GOLD,
+    HASH_WOOD,
+    HASH_STONE,
+    HASH_IRON,
+    HASH_WEAPONS,
+    HASH_CLASS,                          // one field per social class
+    HASH_HAPPINESS = HASH_CLASS + 4,
+    HASH_FARMS,
+    HASH_BARRACKS,
+    HASH_MINES,
+    HASH_BLACKSMITHS,
+    HASH_ARMY_SOLDIERS,
+    HASH_ARMY_WEAPONS,
+    HASH_MORALE,
+    HASH_AT_WAR,
+    HASH_BANK_RESERVE,
+    HASH_BANK_TRUST,
+    HASH_LOAN,                           // balance; one field per loan slot
+    HASH_LOAN_TERM = HASH_LOAN + 8,      // one field per loan slot
+    HASH_LOAN_RATE = HASH_LOAN_TERM + 8, // one field per loan slot
+    HASH_LOAN_PAYMENT = HASH_LOAN_RATE + 8, // one field per loan slot
+    HASH_FOOD_PRICE = HASH_LOAN_PAYMENT + 8,
+    HASH_WEAPON_PRICE,
+    HASH_COHORT                          // one field per population cohort
+};
+
+// MurmurHash3's 64-bit finalizer: a bijection, so distinct (field, value)
+// pairs never share a key while values stay below 2^48
+inline uint64_t zobristKey(int field, int64_t value) {
+    uint64_t z = static_cast<uint64_t>(value) + (static_cast<uint64_t>(field) << 48);
+    z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDULL;
+    z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+    return z ^ (z >> 33);
+}
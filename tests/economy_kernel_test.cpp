@@ -0,0 +1,67 @@
+// Checks KingdomBatch::advanceEconomy (SIMD) and advanceEconomyScalar against
+// each other and against Kingdom::economyPhase, turn by turn, for kingdoms
+// played into varied states with loans outstanding.
+#include "../src/Kingdom.h"
+#include "../src/KingdomBatch.h"
+#include "../src/KingdomRecord.h"
+#include "../src/ActionSource.h"
+#include "../src/Narrator.h"
+#include <cstdio>
+#include <cstring>
+
+static const size_t KINGDOMS = 1003;   // not a multiple of the vector width
+static const int TURNS = 40;
+
+static bool sameRecord(const Kingdom& a, const Kingdom& b) {
+    KingdomRecord ra = KingdomRecord::capture(a);
+    KingdomRecord rb = KingdomRecord::capture(b);
+    return memcmp(&ra, &rb, sizeof(ra)) == 0;
+}
+
+int main() {
+    narrator().mute();
+
+    vector<Kingdom> reference;
+    reference.reserve(KINGDOMS);
+    Random policyRng(7);
+    for (size_t i = 0; i < KINGDOMS; i++) {
+        Kingdom kingdom(static_cast<Difficulty>(i % 3), i + 1);
+        int warmup = static_cast<int>(i % 50);
+        for (int t = 0; t < warmup && !kingdom.isGameOver(); t++) {
+            kingdom.step(randomPolicy(kingdom, policyRng));
+        }
+        reference.push_back(kingdom);
+    }
+
+    KingdomBatch vectorBatch(KINGDOMS);
+    KingdomBatch scalarBatch(KINGDOMS);
+    for (size_t i = 0; i < KINGDOMS; i++) {
+        vectorBatch.load(i, reference[i]);
+        scalarBatch.load(i, reference[i]);
+    }
+
+    int failures = 0;
+    for (int t = 0; t < TURNS; t++) {
+        vectorBatch.advanceEconomy();
+        scalarBatch.advanceEconomyScalar();
+        for (size_t i = 0; i < KINGDOMS; i++) {
+            reference[i].economyPhase();
+            reference[i].turn++;
+
+            Kingdom fromVector = reference[i].fork();
+            Kingdom fromScalar = reference[i].fork();
+            vectorBatch.store(i, fromVector);
+            scalarBatch.store(i, fromScalar);
+            if (!sameRecord(fromVector, fromScalar) || !sameRecord(fromScalar, reference[i])) {
+                if (failures < 10) {
+                    printf("turn %d kingdom %zu: batch economy differs from Kingdom::economyPhase\n", t, i);
+                }
+                failures++;
+            }
+        }
+    }
+
+    printf("%zu kingdoms x %d turns (%s): %d mismatches\n", KINGDOMS, TURNS,
+        KingdomBatch::isVectorized() ? "AVX2" : "scalar", failures);
+    return failures == 0 ? 0 : 1;
+}
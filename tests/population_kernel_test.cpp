@@ -0,0 +1,59 @@
+// Checks that Population::project (SIMD) and projectScalar agree bit for bit,
+// on random cohort arrays and along whole runs of turns, and that advance and
+// advanceScalar leave the same class counts. Checkpoint deltas are taken
+// against project(), so a build where the two differ cannot share files.
+#include "../src/Population.h"
+#include "../src/Random.h"
+#include <cstdio>
+#include <cstring>
+
+static const int STARTS = 2000;
+static const int TURNS = 200;
+
+int main() {
+    narrator().mute();
+    Random rng(11);
+    int failures = 0;
+
+    for (int s = 0; s < STARTS; s++) {
+        float vectorCohorts[COHORT_COUNT];
+        float scalarCohorts[COHORT_COUNT];
+        // Magnitudes from a handful of people to millions
+        float scale = static_cast<float>(1 << rng.next(21));
+        for (int i = 0; i < COHORT_COUNT; i++) {
+            vectorCohorts[i] = scale * rng.next(10000) / 10000.0f;
+        }
+        memcpy(scalarCohorts, vectorCohorts, sizeof(scalarCohorts));
+
+        for (int t = 0; t < TURNS; t++) {
+            float vectorNext[COHORT_COUNT];
+            float scalarNext[COHORT_COUNT];
+            Population::project(vectorCohorts, vectorNext);
+            Population::projectScalar(scalarCohorts, scalarNext);
+            if (memcmp(vectorNext, scalarNext, sizeof(vectorNext)) != 0) {
+                if (failures < 10) printf("start %d turn %d: project differs from projectScalar\n", s, t);
+                failures++;
+                break;
+            }
+            memcpy(vectorCohorts, vectorNext, sizeof(vectorNext));
+            memcpy(scalarCohorts, scalarNext, sizeof(scalarNext));
+        }
+    }
+
+    for (int s = 0; s < STARTS; s++) {
+        Population vectorPop(rng.next(5000), rng.next(500), rng.next(100), rng.next(300), rng.next(101));
+        Population scalarPop = vectorPop;
+        for (int t = 0; t < TURNS; t++) {
+            vectorPop.advance();
+            scalarPop.advanceScalar();
+            if (vectorPop.hash() != scalarPop.hash() || vectorPop.getTotal() != scalarPop.getTotal()) {
+                if (failures < 10) printf("population %d turn %d: advance differs from advanceScalar\n", s, t);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    printf("%d starts x %d turns: %d mismatches\n", STARTS, TURNS, failures);
+    return failures == 0 ? 0 : 1;
+}